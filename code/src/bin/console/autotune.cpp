@@ -0,0 +1,290 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file autotune.cpp
+    \brief This file is a binary for tuning the processing parameters on a
+           dataset of log files with ground truth.
+  */
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+#include "base/ScopedTimer.h"
+#include "base/ThreadPool.h"
+#include "processing/Processor.h"
+#include "data-structures/PointCloud.h"
+#include "evaluation/Evaluator.h"
+
+/// Candidate DEM cell sizes
+static const double demCellSizes[] = {0.1, 0.15, 0.2};
+/// Candidate segmentation parameters
+static const double ks[] = {100.0, 300.0, 1000.0};
+/// Candidate ML maximum numbers of iterations
+static const size_t maxMLIters[] = {50, 200};
+/// Candidate ML tolerances
+static const double mlTols[] = {1e-4, 1e-6};
+/// Candidate Potts prior strengths
+static const double bpStrengths[] = {1.0, 10.0, 50.0};
+/// Candidate BP tolerances
+static const double bpTols[] = {1e-4, 1e-6};
+
+/// Number of candidates of each parameter, in pipeline order
+static const size_t numCandidates[] = {
+  sizeof(demCellSizes) / sizeof(double), sizeof(ks) / sizeof(double),
+  sizeof(maxMLIters) / sizeof(size_t), sizeof(mlTols) / sizeof(double),
+  sizeof(bpStrengths) / sizeof(double), sizeof(bpTols) / sizeof(double)};
+/// Number of tuned parameters
+static const size_t numParams = sizeof(numCandidates) / sizeof(size_t);
+
+/** The NullBuffer class swallows the progress output of the processors.
+    \brief Stream buffer discarding its input
+  */
+class NullBuffer :
+  public std::streambuf {
+protected:
+  /// Discards a character
+  virtual int overflow(int c) {
+    return c;
+  }
+};
+
+/** The Result structure holds the score of a configuration on a scan.
+    \brief Result of a configuration on a scan
+  */
+struct Result {
+  /// Pipeline latency, including the memoised stages
+  double mLatency;
+  /// V-measure of the labeling, 0 if the processing failed
+  double mVMeasure;
+};
+
+/** The Sweep class runs a parameter sweep over a dataset. Each stage of the
+    pipeline is computed once per distinct prefix of parameters: the DEM is
+    shared by all configurations with the same cell size, the segmentation by
+    all ML and BP settings, and the mixture by all BP settings.
+    \brief Memoised parameter sweep
+  */
+class Sweep :
+  public ThreadPool::Task {
+public:
+  /// Constructor
+  Sweep(const std::vector<PointCloud<> >& pointClouds,
+      const std::vector<Evaluator>& evaluators,
+      const std::vector<bool>& selected) :
+      mPointClouds(pointClouds),
+      mEvaluators(evaluators),
+      mSelected(selected),
+      mNumConfigs(selected.size()),
+      mResults(pointClouds.size() * selected.size()),
+      mDEMStage(true) {
+    const Processor defaults;
+    for (size_t i = 0; i < pointClouds.size() * numCandidates[0]; ++i) {
+      const double cellSize = demCellSizes[i % numCandidates[0]];
+      mDEMs.push_back(Processor(defaults.getMinDEM(), defaults.getMaxDEM(),
+        Grid<double, Cell, 2>::Coordinate(cellSize, cellSize)));
+    }
+    mDEMTimes.resize(mDEMs.size());
+  }
+  /// Runs the sweep
+  void run(size_t numThreads) {
+    ThreadPool pool(numThreads);
+    mDEMStage = true;
+    pool.process(*this, mDEMs.size());
+    mDEMStage = false;
+    pool.process(*this, mDEMs.size() * numCandidates[1]);
+  }
+  /// Returns the result of a configuration on a scan
+  const Result& getResult(size_t scan, size_t config) const {
+    return mResults[scan * mNumConfigs + config];
+  }
+  /// Builds a DEM, or runs all configurations sharing a segmentation
+  virtual void process(size_t index) {
+    if (mDEMStage) {
+      if (!isSelected(index % numCandidates[0], 1))
+        return;
+      ScopedTimer timer("autotune::buildDEM()");
+      mDEMs[index].buildDEM(mPointClouds[index / numCandidates[0]]);
+      mDEMTimes[index] = timer.stop();
+      return;
+    }
+    const size_t dem = index / numCandidates[1];
+    const size_t scan = dem / numCandidates[0];
+    const size_t prefix = (dem % numCandidates[0]) * numCandidates[1] +
+      index % numCandidates[1];
+    if (!isSelected(prefix, 2))
+      return;
+    Evaluator evaluator(mEvaluators[scan]);
+    Processor segmentation(mDEMs[dem]);
+    segmentation.setSegmentationParam(ks[index % numCandidates[1]]);
+    ScopedTimer segTimer("autotune::segmentDEM()");
+    const bool segmented = segmentation.segmentDEM();
+    const double segTime = mDEMTimes[dem] + segTimer.stop();
+    for (size_t ml = 0; ml < numCandidates[2] * numCandidates[3]; ++ml) {
+      const size_t mlPrefix = prefix * numCandidates[2] * numCandidates[3] +
+        ml;
+      if (!isSelected(mlPrefix, 4))
+        continue;
+      Processor mixture(segmentation);
+      mixture.setMLMaxIter(maxMLIters[ml / numCandidates[3]]);
+      mixture.setMLTol(mlTols[ml % numCandidates[3]]);
+      ScopedTimer mlTimer("autotune::estimateMixture()");
+      const bool estimated = segmented && mixture.estimateMixture();
+      const double mlTime = segTime + mlTimer.stop();
+      for (size_t bp = 0; bp < numCandidates[4] * numCandidates[5]; ++bp) {
+        const size_t config = mlPrefix * numCandidates[4] * numCandidates[5] +
+          bp;
+        if (!mSelected[config])
+          continue;
+        Processor labeling(mixture);
+        labeling.setBPStrength(bpStrengths[bp / numCandidates[5]]);
+        labeling.setBPTol(bpTols[bp % numCandidates[5]]);
+        ScopedTimer bpTimer("autotune::labelVertices()");
+        const bool valid = estimated && labeling.labelVertices();
+        Result& result = mResults[scan * mNumConfigs + config];
+        result.mLatency = mlTime + bpTimer.stop();
+        result.mVMeasure = valid ? evaluator.evaluate(labeling.getDEM(),
+          labeling.getDEMGraph(), labeling.getVerticesLabels()) : 0.0;
+      }
+    }
+  }
+protected:
+  /// Check if any selected configuration starts with a parameter prefix
+  bool isSelected(size_t prefix, size_t prefixLength) const {
+    size_t numSuffixes = 1;
+    for (size_t i = prefixLength; i < numParams; ++i)
+      numSuffixes *= numCandidates[i];
+    for (size_t i = prefix * numSuffixes; i < (prefix + 1) * numSuffixes;
+        ++i)
+      if (mSelected[i])
+        return true;
+    return false;
+  }
+  /// Point clouds of the dataset
+  const std::vector<PointCloud<> >& mPointClouds;
+  /// Evaluators of the dataset
+  const std::vector<Evaluator>& mEvaluators;
+  /// Selected configurations
+  const std::vector<bool>& mSelected;
+  /// Number of configurations
+  size_t mNumConfigs;
+  /// DEM of each scan and cell size
+  std::vector<Processor> mDEMs;
+  /// Time spent building each DEM
+  std::vector<double> mDEMTimes;
+  /// Result of each configuration on each scan
+  std::vector<Result> mResults;
+  /// Building the DEMs
+  bool mDEMStage;
+};
+
+/// Prints the parameters of a configuration
+static std::ostream& printConfig(std::ostream& stream, size_t config) {
+  size_t idx[numParams];
+  for (size_t i = numParams; i > 0; --i) {
+    idx[i - 1] = config % numCandidates[i - 1];
+    config /= numCandidates[i - 1];
+  }
+  return stream << "demCellSize = " << demCellSizes[idx[0]] << ", k = "
+    << ks[idx[1]] << ", maxMLIter = " << maxMLIters[idx[2]] << ", mlTol = "
+    << mlTols[idx[3]] << ", strength = " << bpStrengths[idx[4]]
+    << ", bpTol = " << bpTols[idx[5]];
+}
+
+int main (int argc, char** argv) {
+  size_t numSamples = 0;
+  size_t numThreads = 0;
+  int arg = 1;
+  for (; arg + 1 < argc && argv[arg][0] == '-'; arg += 2)
+    if (std::string(argv[arg]) == "-r")
+      numSamples = atoi(argv[arg + 1]);
+    else if (std::string(argv[arg]) == "-t")
+      numThreads = atoi(argv[arg + 1]);
+    else
+      break;
+  if (arg >= argc || argv[arg][0] == '-') {
+    std::cerr << "Usage: " << argv[0] << " [-r <num-samples>] "
+      "[-t <num-threads>] <log-file> [<log-file> ...]" << std::endl;
+    return 1;
+  }
+  std::vector<PointCloud<> > pointClouds;
+  std::vector<Evaluator> evaluators;
+  for (; arg < argc; ++arg) {
+    std::string logFilename(argv[arg]);
+    size_t pos = logFilename.find(".csv");
+    if (pos == 0)
+      pos = logFilename.find(".log");
+    if (!pos)
+      return 1;
+    std::string gtFilename = logFilename.substr(0, logFilename.size() - 4);
+    gtFilename.append(".gt");
+    std::ifstream logFile(logFilename.c_str());
+    pointClouds.push_back(PointCloud<>());
+    logFile >> pointClouds.back();
+    std::ifstream gtFile(gtFilename.c_str());
+    evaluators.push_back(Evaluator());
+    gtFile >> evaluators.back();
+  }
+  size_t numConfigs = 1;
+  for (size_t i = 0; i < numParams; ++i)
+    numConfigs *= numCandidates[i];
+  std::vector<bool> selected(numConfigs, numSamples == 0);
+  if (numSamples) {
+    std::vector<size_t> configs(numConfigs);
+    for (size_t i = 0; i < numConfigs; ++i)
+      configs[i] = i;
+    std::random_shuffle(configs.begin(), configs.end());
+    for (size_t i = 0; i < std::min(numSamples, numConfigs); ++i)
+      selected[configs[i]] = true;
+  }
+  Sweep sweep(pointClouds, evaluators, selected);
+  NullBuffer nullBuffer;
+  std::streambuf* coutBuffer = std::cout.rdbuf(&nullBuffer);
+  ScopedTimer timer("autotune::run()");
+  sweep.run(numThreads);
+  const double sweepTime = timer.stop();
+  std::cout.rdbuf(coutBuffer);
+  std::cout << "Sweep time: " << sweepTime << " [s]" << std::endl;
+  std::vector<std::pair<double, std::pair<double, size_t> > > scores;
+  for (size_t i = 0; i < numConfigs; ++i) {
+    if (!selected[i])
+      continue;
+    double latency = 0.0;
+    double vMeasure = 0.0;
+    for (size_t j = 0; j < pointClouds.size(); ++j) {
+      latency += sweep.getResult(j, i).mLatency;
+      vMeasure += sweep.getResult(j, i).mVMeasure;
+    }
+    scores.push_back(std::make_pair(latency / pointClouds.size(),
+      std::make_pair(vMeasure / pointClouds.size(), i)));
+    printConfig(std::cout, i) << ": latency = " << scores.back().first
+      << " [s], V-Measure = " << scores.back().second.first << std::endl;
+  }
+  std::sort(scores.begin(), scores.end());
+  std::cout << "Pareto front (latency against V-Measure):" << std::endl;
+  double bestVMeasure = -1.0;
+  for (size_t i = 0; i < scores.size(); ++i)
+    if (scores[i].second.first > bestVMeasure) {
+      bestVMeasure = scores[i].second.first;
+      printConfig(std::cout, scores[i].second.second) << ": latency = "
+        << scores[i].first << " [s], V-Measure = " << bestVMeasure
+        << std::endl;
+    }
+  return 0;
+}
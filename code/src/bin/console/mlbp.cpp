@@ -22,7 +22,7 @@
 
 #include <string>
 
-#include "base/Timestamp.h"
+#include "base/ScopedTimer.h"
 #include "data-structures/PointCloud.h"
 #include "statistics/EstimatorMLBPMixtureLinearRegression.h"
 #include "evaluation/Evaluator.h"
@@ -37,7 +37,7 @@ int main (int argc, char** argv) {
   std::ifstream logFile(argv[1]);
   PointCloud<> pointCloud;
   logFile >> pointCloud;
-  double start = Timestamp::now();
+  ScopedTimer timer("mlbp::process()");
   Grid<double, Cell, 2> dem(Grid<double, Cell, 2>::Coordinate(0.0, 0.0),
     Grid<double, Cell, 2>::Coordinate(4.0, 4.0),
     Grid<double, Cell, 2>::Coordinate(0.1, 0.1));
@@ -62,6 +62,8 @@ int main (int argc, char** argv) {
         estMixtPlane(*initMixture, dem, graph, pointsMapping, 200, 1e-9);
       const size_t numIter = estMixtPlane.addPointsEM(points.begin(),
         points.end());
+      std::cout << "EM iterations: " << numIter << " (BP iterations: "
+        << estMixtPlane.getNumBPIterations() << ")" << std::endl;
       vertices = estMixtPlane.getVerticesLabels();
     }
     else
@@ -70,8 +72,8 @@ int main (int argc, char** argv) {
   }
   else
     return 1;
-  double stop = Timestamp::now();
-  std::cout << "Point cloud processed: " << stop - start << " [s]" << std::endl;
+  std::cout << "Point cloud processed: " << timer.stop() << " [s]"
+    << std::endl;
   std::string logFilename(argv[1]);
   size_t pos = logFilename.find(".csv");
   if (pos == 0)
@@ -86,7 +88,18 @@ int main (int argc, char** argv) {
   std::ifstream gtFile(gtFilename.c_str());
   Evaluator evaluator;
   gtFile >> evaluator;
-  const double vMeasure = evaluator.evaluate(dem, graph, vertices);
-  std::cout << "V-Measure = " << vMeasure << std::endl;
+  const Evaluator::Metrics metrics = evaluator.computeMetrics(dem, graph,
+    vertices);
+  std::cout << "V-Measure = " << metrics.mVMeasure << std::endl;
+  std::cout << "Homogeneity = " << metrics.mHomogeneity << std::endl;
+  std::cout << "Completeness = " << metrics.mCompleteness << std::endl;
+  std::cout << "Adjusted Rand index = " << metrics.mAdjustedRandIndex
+    << std::endl;
+  for (size_t i = 0; i < metrics.mClassIoU.size(); ++i)
+    std::cout << "IoU of class " << i << " = " << metrics.mClassIoU[i]
+      << std::endl;
+  std::cout << "Boundary precision = " << metrics.mBoundaryPrecision
+    << std::endl;
+  std::cout << "Boundary recall = " << metrics.mBoundaryRecall << std::endl;
   return 0;
 }
@@ -22,7 +22,8 @@
 
 #include <string>
 
-#include "base/Timestamp.h"
+#include "base/ScopedTimer.h"
+#include "base/Profiler.h"
 #include "processing/Processor.h"
 #include "data-structures/PointCloud.h"
 #include "evaluation/Evaluator.h"
@@ -36,10 +37,9 @@ int main (int argc, char** argv) {
   PointCloud<> pointCloud;
   logFile >> pointCloud;
   Processor processor;
-  double before = Timestamp::now();
+  ScopedTimer timer("process-file::processPointCloud()");
   processor.processPointCloud(pointCloud);
-  double after = Timestamp::now();
-  std::cout << "Point cloud processed: " << after - before << " [s]"
+  std::cout << "Point cloud processed: " << timer.stop() << " [s]"
     << std::endl;
   std::string logFilename(argv[1]);
   size_t pos = logFilename.find(".csv");
@@ -55,8 +55,20 @@ int main (int argc, char** argv) {
   std::ifstream gtFile(gtFilename.c_str());
   Evaluator evaluator;
   gtFile >> evaluator;
-  const double vMeasure = evaluator.evaluate(processor.getDEM(),
-    processor.getDEMGraph(), processor.getVerticesLabels());
-  std::cout << "V-Measure = " << vMeasure << std::endl;
+  const Evaluator::Metrics metrics = evaluator.computeMetrics(
+    processor.getDEM(), processor.getDEMGraph(),
+    processor.getVerticesLabels());
+  std::cout << "V-Measure = " << metrics.mVMeasure << std::endl;
+  std::cout << "Homogeneity = " << metrics.mHomogeneity << std::endl;
+  std::cout << "Completeness = " << metrics.mCompleteness << std::endl;
+  std::cout << "Adjusted Rand index = " << metrics.mAdjustedRandIndex
+    << std::endl;
+  for (size_t i = 0; i < metrics.mClassIoU.size(); ++i)
+    std::cout << "IoU of class " << i << " = " << metrics.mClassIoU[i]
+      << std::endl;
+  std::cout << "Boundary precision = " << metrics.mBoundaryPrecision
+    << std::endl;
+  std::cout << "Boundary recall = " << metrics.mBoundaryRecall << std::endl;
+  std::cout << Profiler::getInstance() << std::endl;
   return 0;
 }
@@ -0,0 +1,182 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file queue-benchmark.cpp
+    \brief This file is a benchmark of the lock-free queues against a
+           mutex-protected deque.
+  */
+
+#include <deque>
+#include <cstdlib>
+
+#include "base/Clock.h"
+#include "base/ThreadPool.h"
+#include "base/Mutex.h"
+#include "base/Condition.h"
+#include "base/SPSCQueue.h"
+#include "base/MPMCQueue.h"
+
+/** The LockedQueue class is the reference bounded queue, a deque protected by
+    a mutex with conditions for the blocking operations.
+    \brief Mutex-protected bounded queue
+  */
+template <typename T> class LockedQueue {
+public:
+  /// Constructs queue with a capacity
+  LockedQueue(size_t capacity) :
+      mCapacity(capacity) {
+  }
+  /// Pushes an element, waiting for room
+  bool push(const T& value) {
+    Mutex::ScopedLock lock(mMutex);
+    while (mQueue.size() == mCapacity)
+      mNotFull.wait(mMutex);
+    mQueue.push_back(value);
+    mNotEmpty.signal();
+    return true;
+  }
+  /// Pops an element, waiting for one
+  bool pop(T& value) {
+    Mutex::ScopedLock lock(mMutex);
+    while (mQueue.empty())
+      mNotEmpty.wait(mMutex);
+    value = mQueue.front();
+    mQueue.pop_front();
+    mNotFull.signal();
+    return true;
+  }
+protected:
+  /// Capacity
+  size_t mCapacity;
+  /// Elements
+  std::deque<T> mQueue;
+  /// Mutex protecting the elements
+  Mutex mMutex;
+  /// Condition for consumers waiting on an empty queue
+  Condition mNotEmpty;
+  /// Condition for producers waiting on a full queue
+  Condition mNotFull;
+};
+
+/** The Transfer class moves elements from producer to consumer tasks through
+    a queue. The first tasks produce, the remaining ones consume.
+    \brief Producer and consumer tasks of the benchmark
+  */
+template <typename Q> class Transfer :
+  public ThreadPool::Task {
+public:
+  /// Constructor
+  Transfer(Q& queue, size_t numProducers, size_t numConsumers,
+      size_t numElements) :
+      mQueue(queue),
+      mNumProducers(numProducers),
+      mNumConsumers(numConsumers),
+      mNumElements(numElements),
+      mSums(numConsumers, 0) {
+  }
+  /// Produces or consumes a share of the elements
+  virtual void process(size_t index) {
+    if (index < mNumProducers) {
+      for (size_t i = index; i < mNumElements; i += mNumProducers)
+        if (!mQueue.push(i)) {
+          std::cerr << "Producer " << index << " failed to push"
+            << std::endl;
+          return;
+        }
+      return;
+    }
+    const size_t consumer = index - mNumProducers;
+    size_t sum = 0;
+    for (size_t i = consumer; i < mNumElements; i += mNumConsumers) {
+      size_t value = 0;
+      if (!mQueue.pop(value)) {
+        std::cerr << "Consumer " << consumer << " failed to pop"
+          << std::endl;
+        break;
+      }
+      sum += value;
+    }
+    mSums[consumer] = sum;
+  }
+  /// Returns the sum of all consumed elements
+  size_t getSum() const {
+    size_t sum = 0;
+    for (size_t i = 0; i < mSums.size(); ++i)
+      sum += mSums[i];
+    return sum;
+  }
+protected:
+  /// Queue
+  Q& mQueue;
+  /// Number of producers
+  size_t mNumProducers;
+  /// Number of consumers
+  size_t mNumConsumers;
+  /// Number of elements
+  size_t mNumElements;
+  /// Sum of the elements seen by each consumer
+  std::vector<size_t> mSums;
+};
+
+/// Runs one benchmark and prints the throughput
+template <typename Q> void benchmark(const std::string& name, Q& queue,
+    size_t numProducers, size_t numConsumers, size_t numElements) {
+  Transfer<Q> transfer(queue, numProducers, numConsumers, numElements);
+  ThreadPool pool(numProducers + numConsumers);
+  const Clock::Nanoseconds before = Clock::now();
+  pool.process(transfer, numProducers + numConsumers);
+  const double time = Clock::getSeconds(Clock::now() - before);
+  const bool valid =
+    transfer.getSum() == numElements * (numElements - 1) / 2;
+  std::cout << name << " (" << numProducers << "P/" << numConsumers
+    << "C): " << numElements / time << " [elements/s]"
+    << (valid ? "" : " (corrupted)") << std::endl;
+}
+
+int main (int argc, char** argv) {
+  if (argc > 3) {
+    std::cerr << "Usage: " << argv[0] << " [<num-elements>] [<capacity>]"
+      << std::endl;
+    return 1;
+  }
+  const size_t numElements = argc > 1 ? atoi(argv[1]) : 1000000;
+  const size_t capacity = argc > 2 ? atoi(argv[2]) : 1024;
+  {
+    LockedQueue<size_t> queue(capacity);
+    benchmark("Mutex deque", queue, 1, 1, numElements);
+  }
+  {
+    SPSCQueue<size_t> queue(capacity);
+    benchmark("SPSC queue", queue, 1, 1, numElements);
+  }
+  {
+    MPMCQueue<size_t> queue(capacity);
+    benchmark("MPMC queue", queue, 1, 1, numElements);
+  }
+  const size_t numThreads = std::max(ThreadPool::getNumCPUs() / 2,
+    (size_t)2);
+  {
+    LockedQueue<size_t> queue(capacity);
+    benchmark("Mutex deque", queue, numThreads, numThreads, numElements);
+  }
+  {
+    MPMCQueue<size_t> queue(capacity);
+    benchmark("MPMC queue", queue, numThreads, numThreads, numElements);
+  }
+  return 0;
+}
@@ -0,0 +1,97 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include "base/Arena.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+
+/******************************************************************************/
+/* Constructors and Destructor                                                */
+/******************************************************************************/
+
+Arena::Arena(size_t chunkSize) :
+    mChunk(0),
+    mOffset(0),
+    mSize(0),
+    mCapacity(0) {
+  addChunk(std::max(chunkSize, (size_t)1));
+}
+
+Arena::~Arena() {
+  for (size_t i = 0; i < mChunks.size(); ++i)
+    delete [] mChunks[i];
+}
+
+/******************************************************************************/
+/* Accessors                                                                  */
+/******************************************************************************/
+
+size_t Arena::getSize() const {
+  return mSize;
+}
+
+size_t Arena::getCapacity() const {
+  return mCapacity;
+}
+
+size_t Arena::getNumChunks() const {
+  return mChunks.size();
+}
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+void Arena::addChunk(size_t size) {
+  mChunks.push_back(new char[size]);
+  mChunkSizes.push_back(size);
+  mCapacity += size;
+  mChunk = mChunks.size() - 1;
+  mOffset = 0;
+}
+
+void* Arena::allocate(size_t size, size_t alignment) {
+  const uintptr_t base = (uintptr_t)mChunks[mChunk];
+  size_t offset = ((base + mOffset + alignment - 1) & ~(alignment - 1)) -
+    base;
+  if (offset + size > mChunkSizes[mChunk]) {
+    addChunk(std::max(mCapacity, size + alignment));
+    const uintptr_t chunk = (uintptr_t)mChunks[mChunk];
+    offset = ((chunk + alignment - 1) & ~(alignment - 1)) - chunk;
+  }
+  mOffset = offset + size;
+  mSize += size;
+  return mChunks[mChunk] + offset;
+}
+
+void Arena::reset() {
+  if (mChunks.size() > 1) {
+    for (size_t i = 0; i < mChunks.size(); ++i)
+      delete [] mChunks[i];
+    mChunks.clear();
+    mChunkSizes.clear();
+    const size_t capacity = mCapacity;
+    mCapacity = 0;
+    addChunk(capacity);
+  }
+  mChunk = 0;
+  mOffset = 0;
+  mSize = 0;
+}
@@ -0,0 +1,110 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file Arena.h
+    \brief This file defines the Arena class, which provides a resettable
+           monotonic memory arena
+  */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <vector>
+
+/** The class Arena hands out memory from large chunks by bumping a pointer.
+    Memory is never released individually but all at once by reset(), after
+    which the chunks are reused. A reset after a growth coalesces the chunks
+    into one, so that a workload repeated between resets stops allocating
+    after its first run. The arena is not thread-safe.
+    \brief Resettable monotonic memory arena
+  */
+class Arena {
+  /** \name Private constructors
+    @{
+    */
+  /// Copy constructor
+  Arena(const Arena& other);
+  /// Assignment operator
+  Arena& operator = (const Arena& other);
+  /** @}
+    */
+
+public:
+  /** \name Constructors/Destructor
+    @{
+    */
+  /// Constructs the arena with the size of its first chunk in bytes
+  Arena(size_t chunkSize = 65536);
+  /// Destructor
+  virtual ~Arena();
+  /** @}
+    */
+
+  /** \name Accessors
+    @{
+    */
+  /// Returns the number of bytes handed out since the last reset
+  size_t getSize() const;
+  /// Returns the number of bytes reserved by the chunks
+  size_t getCapacity() const;
+  /// Returns the number of chunks
+  size_t getNumChunks() const;
+  /** @}
+    */
+
+  /** \name Methods
+    @{
+    */
+  /// Allocates memory with the given alignment, a power of two
+  void* allocate(size_t size, size_t alignment);
+  /// Releases all memory handed out since the last reset
+  void reset();
+  /** @}
+    */
+
+protected:
+  /** \name Protected methods
+    @{
+    */
+  /// Adds a chunk of the given size in bytes and makes it current
+  void addChunk(size_t size);
+  /** @}
+    */
+
+  /** \name Protected members
+    @{
+    */
+  /// Chunks memory
+  std::vector<char*> mChunks;
+  /// Chunks sizes in bytes
+  std::vector<size_t> mChunkSizes;
+  /// Current chunk
+  size_t mChunk;
+  /// Offset in the current chunk in bytes
+  size_t mOffset;
+  /// Bytes handed out since the last reset
+  size_t mSize;
+  /// Bytes reserved by the chunks
+  size_t mCapacity;
+  /** @}
+    */
+
+};
+
+#endif // ARENA_H
@@ -0,0 +1,128 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file ArenaAllocator.h
+    \brief This file defines the ArenaAllocator class, which is a standard
+           allocator drawing from an arena
+  */
+
+#ifndef ARENAALLOCATOR_H
+#define ARENAALLOCATOR_H
+
+#include <cstddef>
+
+#include "base/Arena.h"
+
+/** The class ArenaAllocator is a standard allocator drawing its memory from
+    an Arena, and deallocation does nothing. A default-constructed allocator
+    has no arena and falls back to the global operator new, so that containers
+    using it behave as usual unless given an arena. Containers drawing from an
+    arena must be destroyed before the arena is reset.
+    \brief Standard allocator drawing from an arena
+  */
+template <typename T> class ArenaAllocator {
+public:
+  /** \name Types definitions
+    @{
+    */
+  /// Value type
+  typedef T value_type;
+  /// Pointer type
+  typedef T* pointer;
+  /// Constant pointer type
+  typedef const T* const_pointer;
+  /// Reference type
+  typedef T& reference;
+  /// Constant reference type
+  typedef const T& const_reference;
+  /// Size type
+  typedef size_t size_type;
+  /// Difference type
+  typedef ptrdiff_t difference_type;
+  /// Allocator for another type
+  template <typename U> struct rebind {
+    /// Rebound allocator
+    typedef ArenaAllocator<U> other;
+  };
+  /** @}
+    */
+
+  /** \name Constructors/destructor
+    @{
+    */
+  /// Constructs the allocator from an arena, 0 for the global heap
+  ArenaAllocator(Arena* arena = 0);
+  /// Copy constructor
+  ArenaAllocator(const ArenaAllocator& other);
+  /// Copy constructor from an allocator of another type
+  template <typename U> ArenaAllocator(const ArenaAllocator<U>& other);
+  /// Assignment operator
+  ArenaAllocator& operator = (const ArenaAllocator& other);
+  /// Destructor
+  ~ArenaAllocator();
+  /** @}
+    */
+
+  /** \name Accessors
+    @{
+    */
+  /// Returns the arena, 0 for the global heap
+  Arena* getArena() const;
+  /// Returns the address of a value
+  pointer address(reference value) const;
+  /// Returns the address of a value
+  const_pointer address(const_reference value) const;
+  /// Returns the maximum number of values that can be allocated
+  size_type max_size() const;
+  /** @}
+    */
+
+  /** \name Methods
+    @{
+    */
+  /// Allocates storage for values
+  pointer allocate(size_type numValues, const void* hint = 0);
+  /// Deallocates storage for values
+  void deallocate(pointer values, size_type numValues);
+  /// Constructs a value in place
+  void construct(pointer value, const T& other);
+  /// Destroys a value in place
+  void destroy(pointer value);
+  /// Allocators are equal if they share the same arena
+  template <typename U> bool operator == (const ArenaAllocator<U>& other)
+    const;
+  /// Allocators are equal if they share the same arena
+  template <typename U> bool operator != (const ArenaAllocator<U>& other)
+    const;
+  /** @}
+    */
+
+protected:
+  /** \name Protected members
+    @{
+    */
+  /// Arena, 0 for the global heap
+  Arena* mArena;
+  /** @}
+    */
+
+};
+
+#include "base/ArenaAllocator.tpp"
+
+#endif // ARENAALLOCATOR_H
@@ -0,0 +1,117 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include <new>
+#include <limits>
+
+/******************************************************************************/
+/* Constructors and Destructor                                                */
+/******************************************************************************/
+
+template <typename T>
+ArenaAllocator<T>::ArenaAllocator(Arena* arena) :
+    mArena(arena) {
+}
+
+template <typename T>
+ArenaAllocator<T>::ArenaAllocator(const ArenaAllocator& other) :
+    mArena(other.mArena) {
+}
+
+template <typename T>
+template <typename U>
+ArenaAllocator<T>::ArenaAllocator(const ArenaAllocator<U>& other) :
+    mArena(other.getArena()) {
+}
+
+template <typename T>
+ArenaAllocator<T>& ArenaAllocator<T>::operator = (const ArenaAllocator&
+    other) {
+  mArena = other.mArena;
+  return *this;
+}
+
+template <typename T>
+ArenaAllocator<T>::~ArenaAllocator() {
+}
+
+/******************************************************************************/
+/* Accessors                                                                  */
+/******************************************************************************/
+
+template <typename T>
+Arena* ArenaAllocator<T>::getArena() const {
+  return mArena;
+}
+
+template <typename T>
+typename ArenaAllocator<T>::pointer ArenaAllocator<T>::address(reference
+    value) const {
+  return &value;
+}
+
+template <typename T>
+typename ArenaAllocator<T>::const_pointer ArenaAllocator<T>::address(
+    const_reference value) const {
+  return &value;
+}
+
+template <typename T>
+typename ArenaAllocator<T>::size_type ArenaAllocator<T>::max_size() const {
+  return std::numeric_limits<size_type>::max() / sizeof(T);
+}
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+template <typename T>
+typename ArenaAllocator<T>::pointer ArenaAllocator<T>::allocate(size_type
+    numValues, const void* hint) {
+  if (mArena)
+    return (pointer)mArena->allocate(numValues * sizeof(T), __alignof__(T));
+  return (pointer)::operator new(numValues * sizeof(T));
+}
+
+template <typename T>
+void ArenaAllocator<T>::deallocate(pointer values, size_type numValues) {
+  if (!mArena)
+    ::operator delete(values);
+}
+
+template <typename T>
+void ArenaAllocator<T>::construct(pointer value, const T& other) {
+  new((void*)value) T(other);
+}
+
+template <typename T>
+void ArenaAllocator<T>::destroy(pointer value) {
+  value->~T();
+}
+
+template <typename T>
+template <typename U>
+bool ArenaAllocator<T>::operator == (const ArenaAllocator<U>& other) const {
+  return mArena == other.getArena();
+}
+
+template <typename T>
+template <typename U>
+bool ArenaAllocator<T>::operator != (const ArenaAllocator<U>& other) const {
+  return mArena != other.getArena();
+}
@@ -26,10 +26,15 @@
 /* Constructors and Destructor                                                */
 /******************************************************************************/
 
-BinaryBufferReader::BinaryBufferReader(const char* buffer, size_t size) :
+BinaryBufferReader::BinaryBufferReader(const char* buffer, size_t size, bool
+    copy) :
+    mData(buffer),
+    mSize(size),
     mPos(0) {
-  mBuffer.reserve(size);
-  mBuffer.assign(buffer, buffer + size);
+  if (copy && size) {
+    mBuffer.assign(buffer, buffer + size);
+    mData = &mBuffer[0];
+  }
 }
 
 BinaryBufferReader::~BinaryBufferReader() {
@@ -44,18 +49,22 @@ size_t BinaryBufferReader::getPos() const {
 }
 
 void BinaryBufferReader::setPos(size_t pos) {
-  if (pos >= mBuffer.size())
+  if (pos >= mSize)
     throw OutOfBoundException<size_t>(mPos,
       "BinaryBufferReader::setPos(): invalid position");
   mPos = pos;
 }
 
 size_t BinaryBufferReader::getBufferSize() const {
-  return mBuffer.size();
+  return mSize;
 }
 
 size_t BinaryBufferReader::getReadLeft() const {
-  return mBuffer.size() - mPos;
+  return mSize - mPos;
+}
+
+const char* BinaryBufferReader::getBuffer() const {
+  return mData;
 }
 
 /******************************************************************************/
@@ -63,9 +72,14 @@ size_t BinaryBufferReader::getReadLeft() const {
 /******************************************************************************/
 
 void BinaryBufferReader::read(char* buffer, size_t numBytes) {
-  if (mPos + numBytes > mBuffer.size())
+  memcpy(buffer, readView(numBytes), numBytes);
+}
+
+const char* BinaryBufferReader::readView(size_t numBytes) {
+  if (numBytes > mSize - mPos)
     throw OutOfBoundException<size_t>(mPos,
-      "BinaryBufferReader::readBuffer(): no more bytes available");
-  memcpy(buffer, &mBuffer[mPos], numBytes);
+      "BinaryBufferReader::readView(): no more bytes available");
+  const char* view = mData + mPos;
   mPos += numBytes;
+  return view;
 }
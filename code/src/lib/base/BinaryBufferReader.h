@@ -48,8 +48,8 @@ public:
   /** \name Constructors/destructor
     @{
     */
-  /// Constructs object
-  BinaryBufferReader(const char* buffer, size_t size);
+  /// Constructs object, viewing the buffer in place if copy is false
+  BinaryBufferReader(const char* buffer, size_t size, bool copy = true);
   /// Destructor
   virtual ~BinaryBufferReader();
   /** @}
@@ -66,6 +66,8 @@ public:
   size_t getBufferSize() const;
   /// Returns the remaining size to read
   size_t getReadLeft() const;
+  /// Returns the buffer being read
+  const char* getBuffer() const;
   /** @}
     */
 
@@ -74,6 +76,8 @@ public:
     */
   /// Perform read on the stream
   virtual void read(char* buffer, size_t numBytes);
+  /// Returns a view on the next bytes of the buffer and skips them
+  const char* readView(size_t numBytes);
   /** @}
     */
 
@@ -81,8 +85,12 @@ protected:
   /** \name Protected members
     @{
     */
-  /// Associated byte array
+  /// Associated byte array, empty when viewing an external buffer
   std::vector<char> mBuffer;
+  /// Bytes being read
+  const char* mData;
+  /// Number of bytes being read
+  size_t mSize;
   /// Position of the reader
   size_t mPos;
   /** @}
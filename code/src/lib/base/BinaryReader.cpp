@@ -18,66 +18,93 @@
 
 #include "base/BinaryReader.h"
 
+#include "exceptions/BadArgumentException.h"
+
 /******************************************************************************/
 /* Constructors and Destructor                                                */
 /******************************************************************************/
 
-BinaryReader::BinaryReader() {
+BinaryReader::BinaryReader() :
+    mByteOrder(ByteOrder::getHost()),
+    mSwapBytes(false) {
 }
 
 BinaryReader::~BinaryReader() {
 }
 
+/******************************************************************************/
+/* Accessors                                                                  */
+/******************************************************************************/
+
+ByteOrder::Type BinaryReader::getByteOrder() const {
+  return mByteOrder;
+}
+
+void BinaryReader::setByteOrder(ByteOrder::Type byteOrder) {
+  mByteOrder = byteOrder;
+  mSwapBytes = (byteOrder != ByteOrder::getHost());
+}
+
 /******************************************************************************/
 /* Methods                                                                    */
 /******************************************************************************/
 
 BinaryReader& BinaryReader::operator >> (int8_t& value) {
-  read(reinterpret_cast<char*>(&value), sizeof(value));
+  readWords(reinterpret_cast<char*>(&value), sizeof(value), sizeof(value));
   return *this;
 }
 
 BinaryReader& BinaryReader::operator >> (uint8_t& value) {
-  read(reinterpret_cast<char*>(&value), sizeof(value));
+  readWords(reinterpret_cast<char*>(&value), sizeof(value), sizeof(value));
   return *this;
 }
 
 BinaryReader& BinaryReader::operator >> (int16_t& value) {
-  read(reinterpret_cast<char*>(&value), sizeof(value));
+  readWords(reinterpret_cast<char*>(&value), sizeof(value), sizeof(value));
   return *this;
 }
 
 BinaryReader& BinaryReader::operator >> (uint16_t& value) {
-  read(reinterpret_cast<char*>(&value), sizeof(value));
+  readWords(reinterpret_cast<char*>(&value), sizeof(value), sizeof(value));
   return *this;
 }
 
 BinaryReader& BinaryReader::operator >> (int32_t& value) {
-  read(reinterpret_cast<char*>(&value), sizeof(value));
+  readWords(reinterpret_cast<char*>(&value), sizeof(value), sizeof(value));
   return *this;
 }
 
 BinaryReader& BinaryReader::operator >> (uint32_t& value) {
-  read(reinterpret_cast<char*>(&value), sizeof(value));
+  readWords(reinterpret_cast<char*>(&value), sizeof(value), sizeof(value));
   return *this;
 }
 
 BinaryReader& BinaryReader::operator >> (int64_t& value) {
-  read(reinterpret_cast<char*>(&value), sizeof(value));
+  readWords(reinterpret_cast<char*>(&value), sizeof(value), sizeof(value));
   return *this;
 }
 
 BinaryReader& BinaryReader::operator >> (uint64_t& value) {
-  read(reinterpret_cast<char*>(&value), sizeof(value));
+  readWords(reinterpret_cast<char*>(&value), sizeof(value), sizeof(value));
   return *this;
 }
 
 BinaryReader& BinaryReader::operator >> (float& value) {
-  read(reinterpret_cast<char*>(&value), sizeof(value));
+  readWords(reinterpret_cast<char*>(&value), sizeof(value), sizeof(value));
   return *this;
 }
 
 BinaryReader& BinaryReader::operator >> (double& value) {
-  read(reinterpret_cast<char*>(&value), sizeof(value));
+  readWords(reinterpret_cast<char*>(&value), sizeof(value), sizeof(value));
   return *this;
 }
+
+void BinaryReader::readWords(char* buffer, size_t numBytes, size_t wordSize) {
+  if (!wordSize || numBytes % wordSize)
+    throw BadArgumentException<size_t>(wordSize,
+      "BinaryReader::readWords(): bytes are not made of words", __FILE__,
+      __LINE__);
+  read(buffer, numBytes);
+  if (mSwapBytes)
+    ByteOrder::swap(buffer, numBytes, wordSize);
+}
@@ -27,6 +27,8 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#include "base/ByteOrder.h"
+
 /** The BinaryReader class is an interface for reading basic types from a binary
     stream.
     \brief Binary reader
@@ -53,6 +55,16 @@ public:
   /** @}
     */
 
+  /** \name Accessors
+    @{
+    */
+  /// Returns the byte order of the data, the host's by default
+  ByteOrder::Type getByteOrder() const;
+  /// Sets the byte order of the data
+  void setByteOrder(ByteOrder::Type byteOrder);
+  /** @}
+    */
+
   /** \name Operators
     @{
     */
@@ -84,9 +96,27 @@ public:
     */
   /// Perform read on the stream
   virtual void read(char* buffer, size_t numBytes) = 0;
+  /// Reads words of the given size in one read, in the host byte order
+  void readWords(char* buffer, size_t numBytes, size_t wordSize);
+  /// Reads an array of values made of words of the given size
+  template <typename T> void readArray(T* values, size_t numValues,
+    size_t wordSize = sizeof(T));
+  /** @}
+    */
+
+protected:
+  /** \name Protected members
+    @{
+    */
+  /// Byte order of the data
+  ByteOrder::Type mByteOrder;
+  /// Whether the byte order differs from the host's
+  bool mSwapBytes;
   /** @}
     */
 
 };
 
+#include "base/BinaryReader.tpp"
+
 #endif // BINARYREADER_H
@@ -18,67 +18,98 @@
 
 #include "base/BinaryWriter.h"
 
+#include <string.h>
+
+#include <algorithm>
+
+#include "exceptions/BadArgumentException.h"
+
 /******************************************************************************/
 /* Constructors and Destructor                                                */
 /******************************************************************************/
 
-BinaryWriter::BinaryWriter() {
+BinaryWriter::BinaryWriter() :
+    mByteOrder(ByteOrder::getHost()),
+    mSwapBytes(false) {
 }
 
 BinaryWriter::~BinaryWriter() {
 }
 
+/******************************************************************************/
+/* Accessors                                                                  */
+/******************************************************************************/
+
+ByteOrder::Type BinaryWriter::getByteOrder() const {
+  return mByteOrder;
+}
+
+void BinaryWriter::setByteOrder(ByteOrder::Type byteOrder) {
+  mByteOrder = byteOrder;
+  mSwapBytes = (byteOrder != ByteOrder::getHost());
+}
+
 /******************************************************************************/
 /* Methods                                                                    */
 /******************************************************************************/
 
 BinaryWriter& BinaryWriter::operator << (int8_t value) {
-  write(reinterpret_cast<const char*>(&value), sizeof(value));
+  writeWords(reinterpret_cast<const char*>(&value), sizeof(value),
+    sizeof(value));
   return *this;
 }
 
 BinaryWriter& BinaryWriter::operator << (uint8_t value) {
-  write(reinterpret_cast<const char*>(&value), sizeof(value));
+  writeWords(reinterpret_cast<const char*>(&value), sizeof(value),
+    sizeof(value));
   return *this;
 }
 
 BinaryWriter& BinaryWriter::operator << (int16_t value) {
-  write(reinterpret_cast<const char*>(&value), sizeof(value));
+  writeWords(reinterpret_cast<const char*>(&value), sizeof(value),
+    sizeof(value));
   return *this;
 }
 
 BinaryWriter& BinaryWriter::operator << (uint16_t value) {
-  write(reinterpret_cast<const char*>(&value), sizeof(value));
+  writeWords(reinterpret_cast<const char*>(&value), sizeof(value),
+    sizeof(value));
   return *this;
 }
 
 BinaryWriter& BinaryWriter::operator << (int32_t value) {
-  write(reinterpret_cast<const char*>(&value), sizeof(value));
+  writeWords(reinterpret_cast<const char*>(&value), sizeof(value),
+    sizeof(value));
   return *this;
 }
 
 BinaryWriter& BinaryWriter::operator << (uint32_t value) {
-  write(reinterpret_cast<const char*>(&value), sizeof(value));
+  writeWords(reinterpret_cast<const char*>(&value), sizeof(value),
+    sizeof(value));
   return *this;
 }
 
 BinaryWriter& BinaryWriter::operator << (int64_t value) {
-  write(reinterpret_cast<const char*>(&value), sizeof(value));
+  writeWords(reinterpret_cast<const char*>(&value), sizeof(value),
+    sizeof(value));
   return *this;
 }
 
 BinaryWriter& BinaryWriter::operator << (uint64_t value) {
-  write(reinterpret_cast<const char*>(&value), sizeof(value));
+  writeWords(reinterpret_cast<const char*>(&value), sizeof(value),
+    sizeof(value));
   return *this;
 }
 
 BinaryWriter& BinaryWriter::operator << (float value) {
-  write(reinterpret_cast<const char*>(&value), sizeof(value));
+  writeWords(reinterpret_cast<const char*>(&value), sizeof(value),
+    sizeof(value));
   return *this;
 }
 
 BinaryWriter& BinaryWriter::operator << (double value) {
-  write(reinterpret_cast<const char*>(&value), sizeof(value));
+  writeWords(reinterpret_cast<const char*>(&value), sizeof(value),
+    sizeof(value));
   return *this;
 }
 
@@ -86,3 +117,23 @@ BinaryWriter& BinaryWriter::operator << (const std::string& value) {
   write(reinterpret_cast<const char*>(value.c_str()), value.size());
   return *this;
 }
+
+void BinaryWriter::writeWords(const char* buffer, size_t numBytes, size_t
+    wordSize) {
+  char block[4096];
+  if (!wordSize || numBytes % wordSize || wordSize > sizeof(block))
+    throw BadArgumentException<size_t>(wordSize,
+      "BinaryWriter::writeWords(): bytes are not made of words", __FILE__,
+      __LINE__);
+  if (!mSwapBytes) {
+    write(buffer, numBytes);
+    return;
+  }
+  const size_t blockSize = sizeof(block) / wordSize * wordSize;
+  for (size_t pos = 0; pos < numBytes; pos += blockSize) {
+    const size_t size = std::min(blockSize, numBytes - pos);
+    memcpy(block, buffer + pos, size);
+    ByteOrder::swap(block, size, wordSize);
+    write(block, size);
+  }
+}
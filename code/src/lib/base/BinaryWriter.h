@@ -29,6 +29,8 @@
 
 #include <string>
 
+#include "base/ByteOrder.h"
+
 /** The BinaryWriter class is an interface for writing basic types to a binary
     stream.
     \brief Binary writer
@@ -55,6 +57,16 @@ public:
   /** @}
     */
 
+  /** \name Accessors
+    @{
+    */
+  /// Returns the byte order of the data, the host's by default
+  ByteOrder::Type getByteOrder() const;
+  /// Sets the byte order of the data
+  void setByteOrder(ByteOrder::Type byteOrder);
+  /** @}
+    */
+
   /** \name Operators
     @{
     */
@@ -88,9 +100,27 @@ public:
     */
   /// Performs write on the stream
   virtual void write(const char* buffer, size_t numBytes) = 0;
+  /// Writes words of the given size from the host byte order
+  void writeWords(const char* buffer, size_t numBytes, size_t wordSize);
+  /// Writes an array of values made of words of the given size
+  template <typename T> void writeArray(const T* values, size_t numValues,
+    size_t wordSize = sizeof(T));
+  /** @}
+    */
+
+protected:
+  /** \name Protected members
+    @{
+    */
+  /// Byte order of the data
+  ByteOrder::Type mByteOrder;
+  /// Whether the byte order differs from the host's
+  bool mSwapBytes;
   /** @}
     */
 
 };
 
+#include "base/BinaryWriter.tpp"
+
 #endif // BINARYWRITER_H
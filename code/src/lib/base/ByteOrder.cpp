@@ -0,0 +1,53 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include "base/ByteOrder.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+ByteOrder::Type ByteOrder::getHost() {
+  const uint16_t word = 1;
+  return *reinterpret_cast<const char*>(&word) ? littleEndian : bigEndian;
+}
+
+void ByteOrder::swap(char* buffer, size_t numBytes, size_t wordSize) {
+  if (wordSize == 4)
+    for (size_t i = 0; i + 4 <= numBytes; i += 4) {
+      uint32_t word;
+      memcpy(&word, buffer + i, 4);
+      word = __builtin_bswap32(word);
+      memcpy(buffer + i, &word, 4);
+    }
+  else if (wordSize == 8)
+    for (size_t i = 0; i + 8 <= numBytes; i += 8) {
+      uint64_t word;
+      memcpy(&word, buffer + i, 8);
+      word = __builtin_bswap64(word);
+      memcpy(buffer + i, &word, 8);
+    }
+  else if (wordSize > 1)
+    for (size_t i = 0; i + wordSize <= numBytes; i += wordSize)
+      std::reverse(buffer + i, buffer + i + wordSize);
+}
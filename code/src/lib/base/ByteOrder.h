@@ -0,0 +1,67 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file ByteOrder.h
+    \brief This file defines the ByteOrder class, which provides byte order
+           facilities
+  */
+
+#ifndef BYTEORDER_H
+#define BYTEORDER_H
+
+#include <stdlib.h>
+
+/** The class ByteOrder provides byte order facilities for binary data.
+    \brief Byte order facilities
+  */
+class ByteOrder {
+  /** \name Private constructors
+    @{
+    */
+  /// Default constructor
+  ByteOrder();
+  /** @}
+    */
+
+public:
+  /** \name Types definitions
+    @{
+    */
+  /// Byte order
+  enum Type {
+    /// Least significant byte first
+    littleEndian,
+    /// Most significant byte first
+    bigEndian
+  };
+  /** @}
+    */
+
+  /** \name Methods
+    @{
+    */
+  /// Returns the byte order of the host
+  static Type getHost();
+  /// Reverses the bytes of every word of a buffer
+  static void swap(char* buffer, size_t numBytes, size_t wordSize);
+  /** @}
+    */
+
+};
+
+#endif // BYTEORDER_H
@@ -0,0 +1,43 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include "base/Clock.h"
+
+#include <errno.h>
+#include <time.h>
+
+#include "exceptions/SystemException.h"
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+Clock::Nanoseconds Clock::now() {
+  timespec time;
+  if (clock_gettime(CLOCK_MONOTONIC, &time))
+    throw SystemException(errno, "Clock::now()::clock_gettime()");
+  return (Nanoseconds)time.tv_sec * 1000000000ul + time.tv_nsec;
+}
+
+double Clock::getSeconds(Nanoseconds nanoseconds) {
+  return nanoseconds * 1e-9;
+}
+
+Clock::Nanoseconds Clock::getNanoseconds(double seconds) {
+  return seconds > 0.0 ? (Nanoseconds)(seconds * 1e9 + 0.5) : 0;
+}
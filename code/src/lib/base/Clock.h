@@ -0,0 +1,66 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file Clock.h
+    \brief This file defines the Clock class, which provides a monotonic
+           high-resolution clock
+  */
+
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <stdint.h>
+
+/** The class Clock provides a monotonic clock with nanosecond resolution.
+    Unlike Timestamp::now(), it is not affected by adjustments of the system
+    time and is therefore suited for measuring durations.
+    \brief Monotonic high-resolution clock
+  */
+class Clock {
+  /** \name Private constructors
+    @{
+    */
+  /// Default constructor
+  Clock();
+  /** @}
+    */
+
+public:
+  /** \name Types definitions
+    @{
+    */
+  /// Time in nanoseconds
+  typedef uint64_t Nanoseconds;
+  /** @}
+    */
+
+  /** \name Methods
+    @{
+    */
+  /// Returns the monotonic time in nanoseconds
+  static Nanoseconds now();
+  /// Converts nanoseconds into seconds
+  static double getSeconds(Nanoseconds nanoseconds);
+  /// Converts seconds into nanoseconds
+  static Nanoseconds getNanoseconds(double seconds);
+  /** @}
+    */
+
+};
+
+#endif // CLOCK_H
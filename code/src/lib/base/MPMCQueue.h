@@ -0,0 +1,136 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file MPMCQueue.h
+    \brief This file defines the MPMCQueue class, which is a bounded lock-free
+           queue for any number of producer and consumer threads
+  */
+
+#ifndef MPMCQUEUE_H
+#define MPMCQUEUE_H
+
+#include <vector>
+
+#include "base/QueueCondition.h"
+
+/** The class MPMCQueue implements a bounded lock-free ring buffer shared by
+    any number of producer and consumer threads. Each slot carries a sequence
+    number telling whether it is ready to be written or read for a given
+    position, so the threads only contend on a compare-and-swap of the
+    position counters. The blocking operations sleep on a QueueCondition.
+    \brief Multi-producer multi-consumer lock-free queue
+  */
+template <typename T> class MPMCQueue {
+  /** \name Private constructors
+    @{
+    */
+  /// Copy constructor
+  MPMCQueue(const MPMCQueue& other);
+  /// Assignment operator
+  MPMCQueue& operator = (const MPMCQueue& other);
+  /** @}
+    */
+
+public:
+  /** \name Constructors/Destructor
+    @{
+    */
+  /// Constructs queue with a capacity, rounded up to a power of two
+  MPMCQueue(size_t capacity);
+  /// Destructor
+  virtual ~MPMCQueue();
+  /** @}
+    */
+
+  /** \name Accessors
+    @{
+    */
+  /// Returns the capacity of the queue
+  size_t getCapacity() const;
+  /// Returns the number of queued elements, exact only when idle
+  size_t getSize() const;
+  /** @}
+    */
+
+  /** \name Methods
+    @{
+    */
+  /// Pushes an element if there is room / Returns success
+  bool tryPush(const T& value);
+  /// Pushes an element, waiting for room / Returns false on timeout
+  bool push(const T& value, double seconds = Timer::eternal());
+  /// Pops an element if there is one / Returns success
+  bool tryPop(T& value);
+  /// Pops an element, waiting for one / Returns false on timeout
+  bool pop(T& value, double seconds = Timer::eternal());
+  /** @}
+    */
+
+protected:
+  /** \name Protected types
+    @{
+    */
+  /// Slot of the ring buffer
+  struct Slot {
+    /// Position the slot is ready for
+    volatile size_t mSequence;
+    /// Element
+    T mValue;
+  };
+  /** @}
+    */
+
+  /** \name Protected methods
+    @{
+    */
+  /// Enqueues an element / Returns success
+  bool enqueue(const T& value);
+  /// Dequeues an element / Returns success
+  bool dequeue(T& value);
+  /** @}
+    */
+
+  /** \name Protected members
+    @{
+    */
+  /// Ring buffer
+  std::vector<Slot> mSlots;
+  /// Index mask of the ring buffer
+  size_t mMask;
+  /// Padding separating the positions from the buffer
+  char mPadding0[64];
+  /// Position of the next element to push
+  volatile size_t mEnqueuePosition;
+  /// Padding separating the producer and consumer positions
+  char mPadding1[64];
+  /// Position of the next element to pop
+  volatile size_t mDequeuePosition;
+  /// Padding separating the positions from the conditions
+  char mPadding2[64];
+  /// Condition for consumers waiting on an empty queue
+  QueueCondition mNotEmpty;
+  /// Condition for producers waiting on a full queue
+  QueueCondition mNotFull;
+  /** @}
+    */
+
+};
+
+#include "base/MPMCQueue.tpp"
+
+#endif // MPMCQUEUE_H
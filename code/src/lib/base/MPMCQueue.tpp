@@ -0,0 +1,177 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include <cstddef>
+
+#include "exceptions/BadArgumentException.h"
+
+/******************************************************************************/
+/* Constructors and Destructor                                                */
+/******************************************************************************/
+
+template <typename T>
+MPMCQueue<T>::MPMCQueue(size_t capacity) :
+    mEnqueuePosition(0),
+    mDequeuePosition(0) {
+  if (capacity < 2)
+    throw BadArgumentException<size_t>(capacity,
+      "MPMCQueue<T>::MPMCQueue(): capacity must be at least 2",
+      __FILE__, __LINE__);
+  size_t size = 1;
+  while (size < capacity)
+    size *= 2;
+  mSlots.resize(size);
+  mMask = size - 1;
+  for (size_t i = 0; i < size; ++i)
+    mSlots[i].mSequence = i;
+}
+
+template <typename T>
+MPMCQueue<T>::~MPMCQueue() {
+}
+
+/******************************************************************************/
+/* Accessors                                                                  */
+/******************************************************************************/
+
+template <typename T>
+size_t MPMCQueue<T>::getCapacity() const {
+  return mSlots.size();
+}
+
+template <typename T>
+size_t MPMCQueue<T>::getSize() const {
+  const size_t dequeuePosition = mDequeuePosition;
+  const size_t enqueuePosition = mEnqueuePosition;
+  return enqueuePosition > dequeuePosition ?
+    enqueuePosition - dequeuePosition : 0;
+}
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+template <typename T>
+bool MPMCQueue<T>::enqueue(const T& value) {
+  size_t position = mEnqueuePosition;
+  for (;;) {
+    const size_t sequence = mSlots[position & mMask].mSequence;
+    __sync_synchronize();
+    const ptrdiff_t difference = (ptrdiff_t)(sequence - position);
+    if (difference == 0) {
+      if (__sync_bool_compare_and_swap(&mEnqueuePosition, position,
+          position + 1))
+        break;
+      position = mEnqueuePosition;
+    }
+    else if (difference < 0)
+      return false;
+    else
+      position = mEnqueuePosition;
+  }
+  Slot& slot = mSlots[position & mMask];
+  slot.mValue = value;
+  __sync_synchronize();
+  slot.mSequence = position + 1;
+  return true;
+}
+
+template <typename T>
+bool MPMCQueue<T>::dequeue(T& value) {
+  size_t position = mDequeuePosition;
+  for (;;) {
+    const size_t sequence = mSlots[position & mMask].mSequence;
+    __sync_synchronize();
+    const ptrdiff_t difference = (ptrdiff_t)(sequence - (position + 1));
+    if (difference == 0) {
+      if (__sync_bool_compare_and_swap(&mDequeuePosition, position,
+          position + 1))
+        break;
+      position = mDequeuePosition;
+    }
+    else if (difference < 0)
+      return false;
+    else
+      position = mDequeuePosition;
+  }
+  Slot& slot = mSlots[position & mMask];
+  value = slot.mValue;
+  __sync_synchronize();
+  slot.mSequence = position + mMask + 1;
+  return true;
+}
+
+template <typename T>
+bool MPMCQueue<T>::tryPush(const T& value) {
+  if (!enqueue(value))
+    return false;
+  mNotEmpty.signal();
+  return true;
+}
+
+template <typename T>
+bool MPMCQueue<T>::push(const T& value, double seconds) {
+  if (tryPush(value))
+    return true;
+  bool pushed = false;
+  const Clock::Nanoseconds deadline = QueueCondition::getDeadline(seconds);
+  mNotFull.lock();
+  for (;;) {
+    mNotFull.setWaiting();
+    if ((pushed = enqueue(value)))
+      break;
+    if (!mNotFull.waitUntil(deadline)) {
+      pushed = enqueue(value);
+      break;
+    }
+  }
+  mNotFull.unlock();
+  if (pushed)
+    mNotEmpty.signal();
+  return pushed;
+}
+
+template <typename T>
+bool MPMCQueue<T>::tryPop(T& value) {
+  if (!dequeue(value))
+    return false;
+  mNotFull.signal();
+  return true;
+}
+
+template <typename T>
+bool MPMCQueue<T>::pop(T& value, double seconds) {
+  if (tryPop(value))
+    return true;
+  bool popped = false;
+  const Clock::Nanoseconds deadline = QueueCondition::getDeadline(seconds);
+  mNotEmpty.lock();
+  for (;;) {
+    mNotEmpty.setWaiting();
+    if ((popped = dequeue(value)))
+      break;
+    if (!mNotEmpty.waitUntil(deadline)) {
+      popped = dequeue(value);
+      break;
+    }
+  }
+  mNotEmpty.unlock();
+  if (popped)
+    mNotFull.signal();
+  return popped;
+}
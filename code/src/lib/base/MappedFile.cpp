@@ -0,0 +1,79 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include "base/MappedFile.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include "exceptions/SystemException.h"
+
+/******************************************************************************/
+/* Constructors and Destructor                                                */
+/******************************************************************************/
+
+MappedFile::MappedFile(const std::string& filename) :
+    mFilename(filename),
+    mData(0),
+    mSize(0) {
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd == -1)
+    throw SystemException(errno, "MappedFile::MappedFile()::open()");
+  struct stat status;
+  if (fstat(fd, &status) == -1) {
+    int error = errno;
+    close(fd);
+    throw SystemException(error, "MappedFile::MappedFile()::fstat()");
+  }
+  mSize = status.st_size;
+  if (mSize) {
+    void* data = mmap(0, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      int error = errno;
+      close(fd);
+      throw SystemException(error, "MappedFile::MappedFile()::mmap()");
+    }
+    mData = static_cast<char*>(data);
+    madvise(mData, mSize, MADV_SEQUENTIAL);
+  }
+  close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (mData)
+    munmap(mData, mSize);
+}
+
+/******************************************************************************/
+/* Accessors                                                                  */
+/******************************************************************************/
+
+const std::string& MappedFile::getFilename() const {
+  return mFilename;
+}
+
+const char* MappedFile::getData() const {
+  return mData;
+}
+
+size_t MappedFile::getSize() const {
+  return mSize;
+}
@@ -0,0 +1,85 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file MappedFile.h
+    \brief This file defines the MappedFile class which maps a file read-only
+           into memory.
+  */
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <stdlib.h>
+
+#include <string>
+
+/** The MappedFile class maps an entire file read-only into the address space
+    of the process, such that its content may be parsed in place, e.g., by a
+    BinaryBufferReader viewing the mapped bytes.
+    \brief Read-only memory-mapped file
+  */
+class MappedFile {
+  /** \name Private constructors
+    @{
+    */
+  /// Copy constructor
+  MappedFile(const MappedFile& other);
+  /// Assignment operator
+  MappedFile& operator = (const MappedFile& other);
+  /** @}
+    */
+
+public:
+  /** \name Constructors/destructor
+    @{
+    */
+  /// Constructs object by mapping the given file
+  MappedFile(const std::string& filename);
+  /// Destructor
+  virtual ~MappedFile();
+  /** @}
+    */
+
+  /** \name Accessors
+    @{
+    */
+  /// Returns the mapped filename
+  const std::string& getFilename() const;
+  /// Returns the mapped bytes
+  const char* getData() const;
+  /// Returns the number of mapped bytes
+  size_t getSize() const;
+  /** @}
+    */
+
+protected:
+  /** \name Protected members
+    @{
+    */
+  /// Mapped filename
+  std::string mFilename;
+  /// Mapped bytes
+  char* mData;
+  /// Number of mapped bytes
+  size_t mSize;
+  /** @}
+    */
+
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,131 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include "base/Profiler.h"
+
+#include "exceptions/SystemException.h"
+
+/******************************************************************************/
+/* Statics                                                                    */
+/******************************************************************************/
+
+__thread Profiler::Profile* Profiler::localProfile = 0;
+
+/******************************************************************************/
+/* Constructors and Destructor                                                */
+/******************************************************************************/
+
+Profiler::Profiler() {
+  const int ret = pthread_key_create(&mProfileKey, releaseProfile);
+  if (ret)
+    throw SystemException(ret, "Profiler::Profiler()::pthread_key_create()");
+}
+
+Profiler::~Profiler() {
+  pthread_key_delete(mProfileKey);
+  for (auto it = mProfiles.begin(); it != mProfiles.end(); ++it)
+    delete *it;
+  localProfile = 0;
+}
+
+/******************************************************************************/
+/* Stream operations                                                          */
+/******************************************************************************/
+
+void Profiler::read(std::istream& stream) {
+}
+
+void Profiler::write(std::ostream& stream) const {
+  const Histograms histograms = getHistograms();
+  for (auto it = histograms.begin(); it != histograms.end(); ++it) {
+    if (it != histograms.begin())
+      stream << std::endl;
+    stream << it->first << ": " << it->second;
+  }
+}
+
+void Profiler::read(std::ifstream& stream) {
+}
+
+void Profiler::write(std::ofstream& stream) const {
+  const Histograms histograms = getHistograms();
+  for (auto it = histograms.begin(); it != histograms.end(); ++it) {
+    stream << it->first << " ";
+    stream << it->second;
+  }
+}
+
+/******************************************************************************/
+/* Accessors                                                                  */
+/******************************************************************************/
+
+TimeHistogram& Profiler::getHistogram(const char* name) {
+  Profile* profile = localProfile;
+  if (!profile) {
+    Mutex::ScopedLock lock(mMutex);
+    if (mIdleProfiles.empty()) {
+      profile = new Profile();
+      mProfiles.push_back(profile);
+    }
+    else {
+      profile = mIdleProfiles.back();
+      mIdleProfiles.pop_back();
+    }
+    pthread_setspecific(mProfileKey, profile);
+    localProfile = profile;
+  }
+  auto it = profile->mHistograms.find(name);
+  if (it != profile->mHistograms.end())
+    return it->second;
+  Mutex::ScopedLock lock(profile->mMutex);
+  return profile->mHistograms[name];
+}
+
+Profiler::Histograms Profiler::getHistograms() const {
+  Histograms histograms;
+  Mutex::ScopedLock lock(mMutex);
+  for (auto it = mProfiles.begin(); it != mProfiles.end(); ++it) {
+    Mutex::ScopedLock profileLock((*it)->mMutex);
+    for (auto itHist = (*it)->mHistograms.begin();
+        itHist != (*it)->mHistograms.end(); ++itHist)
+      histograms[itHist->first].merge(itHist->second);
+  }
+  return histograms;
+}
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+void Profiler::releaseProfile(void* profile) {
+  if (!exists())
+    return;
+  Profiler& profiler = getInstance();
+  Mutex::ScopedLock lock(profiler.mMutex);
+  profiler.mIdleProfiles.push_back(static_cast<Profile*>(profile));
+}
+
+void Profiler::reset() {
+  Mutex::ScopedLock lock(mMutex);
+  for (auto it = mProfiles.begin(); it != mProfiles.end(); ++it) {
+    Mutex::ScopedLock profileLock((*it)->mMutex);
+    for (auto itHist = (*it)->mHistograms.begin();
+        itHist != (*it)->mHistograms.end(); ++itHist)
+      itHist->second.reset();
+  }
+}
@@ -0,0 +1,152 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file Profiler.h
+    \brief This file defines the Profiler class, which collects named timing
+           histograms
+  */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <pthread.h>
+
+#include "base/Singleton.h"
+#include "base/Serializable.h"
+#include "base/Mutex.h"
+#include "base/TimeHistogram.h"
+
+/** The class Profiler collects named timing histograms. Every thread records
+    into its own histograms, so that recording never takes a lock once a
+    name has been seen by the thread. The histograms of all threads are
+    merged by name when queried, and survive the threads that recorded them.
+    The profile of an exiting thread is handed over to the next new thread,
+    so that the number of profiles is bounded by the number of threads alive
+    at once.
+    \brief Named timing histograms
+  */
+class Profiler :
+  public Singleton<Profiler>,
+  public virtual Serializable {
+friend class Singleton<Profiler>;
+  /** \name Private constructors
+    @{
+    */
+  /// Copy constructor
+  Profiler(const Profiler& other);
+  /// Assignment operator
+  Profiler& operator = (const Profiler& other);
+  /** @}
+    */
+
+public:
+  /** \name Types definitions
+    @{
+    */
+  /// Histograms merged by name
+  typedef std::map<std::string, TimeHistogram> Histograms;
+  /** @}
+    */
+
+  /** \name Accessors
+    @{
+    */
+  /// Access the calling thread's histogram, name must be a static string
+  TimeHistogram& getHistogram(const char* name);
+  /// Returns the histograms of all threads merged by name
+  Histograms getHistograms() const;
+  /** @}
+    */
+
+  /** \name Methods
+    @{
+    */
+  /// Reset the histograms of all threads
+  void reset();
+  /** @}
+    */
+
+protected:
+  /** \name Protected types definitions
+    @{
+    */
+  /// Histograms recorded by one thread
+  struct Profile {
+    /// Mutex protecting the insertion of histograms
+    mutable Mutex mMutex;
+    /// Histograms indexed by name address
+    std::map<const char*, TimeHistogram> mHistograms;
+  };
+  /** @}
+    */
+
+  /** \name Protected constructors/destructor
+    @{
+    */
+  /// Default constructor
+  Profiler();
+  /// Destructor
+  virtual ~Profiler();
+  /** @}
+    */
+
+  /** \name Protected methods
+    @{
+    */
+  /// Makes the profile of an exiting thread available to new threads
+  static void releaseProfile(void* profile);
+  /** @}
+    */
+
+  /** \name Stream methods
+    @{
+    */
+  /// Reads from standard input
+  virtual void read(std::istream& stream);
+  /// Writes to standard output
+  virtual void write(std::ostream& stream) const;
+  /// Reads from a file
+  virtual void read(std::ifstream& stream);
+  /// Writes to a file
+  virtual void write(std::ofstream& stream) const;
+  /** @}
+    */
+
+  /** \name Protected members
+    @{
+    */
+  /// Profiles of all threads that recorded
+  std::vector<Profile*> mProfiles;
+  /// Profiles of exited threads, reused by new threads
+  std::vector<Profile*> mIdleProfiles;
+  /// Key releasing the profiles of exiting threads
+  pthread_key_t mProfileKey;
+  /// Mutex protecting the profiles
+  mutable Mutex mMutex;
+  /// Profile of the calling thread
+  static __thread Profile* localProfile;
+  /** @}
+    */
+
+};
+
+#endif // PROFILER_H
@@ -0,0 +1,80 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include "base/QueueCondition.h"
+
+#include <limits>
+
+/******************************************************************************/
+/* Constructors and Destructor                                                */
+/******************************************************************************/
+
+QueueCondition::QueueCondition() :
+    mWaiting(false) {
+}
+
+QueueCondition::~QueueCondition() {
+}
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+void QueueCondition::lock() {
+  mMutex.lock();
+}
+
+void QueueCondition::unlock() {
+  mMutex.unlock();
+}
+
+void QueueCondition::setWaiting() {
+  mWaiting = true;
+  __sync_synchronize();
+}
+
+bool QueueCondition::wait(double seconds) {
+  return mCondition.wait(mMutex, seconds);
+}
+
+bool QueueCondition::waitUntil(Clock::Nanoseconds deadline) {
+  if (deadline == std::numeric_limits<Clock::Nanoseconds>::max())
+    return wait(Timer::eternal());
+  const Clock::Nanoseconds now = Clock::now();
+  if (now >= deadline)
+    return false;
+  return wait(Clock::getSeconds(deadline - now));
+}
+
+Clock::Nanoseconds QueueCondition::getDeadline(double seconds) {
+  const Clock::Nanoseconds never =
+    std::numeric_limits<Clock::Nanoseconds>::max();
+  const Clock::Nanoseconds now = Clock::now();
+  if (seconds >= Clock::getSeconds(never - now))
+    return never;
+  return now + Clock::getNanoseconds(seconds);
+}
+
+void QueueCondition::signal() {
+  __sync_synchronize();
+  if (mWaiting) {
+    Mutex::ScopedLock lock(mMutex);
+    mWaiting = false;
+    mCondition.signal(Condition::broadcast);
+  }
+}
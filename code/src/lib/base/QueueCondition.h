@@ -0,0 +1,96 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file QueueCondition.h
+    \brief This file defines the QueueCondition class, which lets threads
+           sleep on a lock-free queue until another thread makes progress
+  */
+
+#ifndef QUEUECONDITION_H
+#define QUEUECONDITION_H
+
+#include "base/Mutex.h"
+#include "base/Condition.h"
+#include "base/Timer.h"
+#include "base/Clock.h"
+
+/** The class QueueCondition puts threads to sleep when a lock-free queue is
+    full or empty. A waiter raises a flag under the mutex before its last
+    check of the queue, and the other side only takes the mutex to signal
+    while the flag is raised, so the uncontended path never enters the
+    kernel and a sleeping waiter is woken up once.
+    \brief Sleeping facilities for lock-free queues
+  */
+class QueueCondition {
+  /** \name Private constructors
+    @{
+    */
+  /// Copy constructor
+  QueueCondition(const QueueCondition& other);
+  /// Assignment operator
+  QueueCondition& operator = (const QueueCondition& other);
+  /** @}
+    */
+
+public:
+  /** \name Constructors/Destructor
+    @{
+    */
+  /// Default constructor
+  QueueCondition();
+  /// Destructor
+  virtual ~QueueCondition();
+  /** @}
+    */
+
+  /** \name Methods
+    @{
+    */
+  /// Locks the condition
+  void lock();
+  /// Unlocks the condition
+  void unlock();
+  /// Flags a waiter before its last check of the queue, while locked
+  void setWaiting();
+  /// Sleeps while locked until signaled / Returns false on timeout
+  bool wait(double seconds = Timer::eternal());
+  /// Sleeps while locked until signaled / Returns false past the deadline
+  bool waitUntil(Clock::Nanoseconds deadline);
+  /// Returns the deadline of a timeout starting now
+  static Clock::Nanoseconds getDeadline(double seconds);
+  /// Wakes up the waiters, if any
+  void signal();
+  /** @}
+    */
+
+protected:
+  /** \name Protected members
+    @{
+    */
+  /// Mutex protecting the sleeping threads
+  Mutex mMutex;
+  /// Condition the threads are sleeping on
+  Condition mCondition;
+  /// Waiter flag, cleared when signaling
+  volatile bool mWaiting;
+  /** @}
+    */
+
+};
+
+#endif // QUEUECONDITION_H
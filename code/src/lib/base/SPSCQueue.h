@@ -0,0 +1,126 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file SPSCQueue.h
+    \brief This file defines the SPSCQueue class, which is a bounded lock-free
+           queue for one producer and one consumer thread
+  */
+
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <vector>
+
+#include "base/QueueCondition.h"
+
+/** The class SPSCQueue implements a bounded lock-free ring buffer between one
+    producer thread and one consumer thread. Each side owns its index and
+    only reads the other one when its cached copy says the queue is full or
+    empty. The blocking operations sleep on a QueueCondition.
+    \brief Single-producer single-consumer lock-free queue
+  */
+template <typename T> class SPSCQueue {
+  /** \name Private constructors
+    @{
+    */
+  /// Copy constructor
+  SPSCQueue(const SPSCQueue& other);
+  /// Assignment operator
+  SPSCQueue& operator = (const SPSCQueue& other);
+  /** @}
+    */
+
+public:
+  /** \name Constructors/Destructor
+    @{
+    */
+  /// Constructs queue with a capacity, rounded up to a power of two
+  SPSCQueue(size_t capacity);
+  /// Destructor
+  virtual ~SPSCQueue();
+  /** @}
+    */
+
+  /** \name Accessors
+    @{
+    */
+  /// Returns the capacity of the queue
+  size_t getCapacity() const;
+  /// Returns the number of queued elements, exact only when idle
+  size_t getSize() const;
+  /** @}
+    */
+
+  /** \name Methods
+    @{
+    */
+  /// Pushes an element if there is room / Returns success
+  bool tryPush(const T& value);
+  /// Pushes an element, waiting for room / Returns false on timeout
+  bool push(const T& value, double seconds = Timer::eternal());
+  /// Pops an element if there is one / Returns success
+  bool tryPop(T& value);
+  /// Pops an element, waiting for one / Returns false on timeout
+  bool pop(T& value, double seconds = Timer::eternal());
+  /** @}
+    */
+
+protected:
+  /** \name Protected methods
+    @{
+    */
+  /// Enqueues an element from the producer thread / Returns success
+  bool enqueue(const T& value);
+  /// Dequeues an element from the consumer thread / Returns success
+  bool dequeue(T& value);
+  /** @}
+    */
+
+  /** \name Protected members
+    @{
+    */
+  /// Ring buffer
+  std::vector<T> mBuffer;
+  /// Index mask of the ring buffer
+  size_t mMask;
+  /// Padding separating the indices from the buffer
+  char mPadding0[64];
+  /// Index of the next element to pop, written by the consumer
+  volatile size_t mHead;
+  /// Consumer's copy of the producer index
+  size_t mTailCache;
+  /// Padding separating the producer and consumer indices
+  char mPadding1[64];
+  /// Index of the next element to push, written by the producer
+  volatile size_t mTail;
+  /// Producer's copy of the consumer index
+  size_t mHeadCache;
+  /// Padding separating the indices from the conditions
+  char mPadding2[64];
+  /// Condition for consumers waiting on an empty queue
+  QueueCondition mNotEmpty;
+  /// Condition for producers waiting on a full queue
+  QueueCondition mNotFull;
+  /** @}
+    */
+
+};
+
+#include "base/SPSCQueue.tpp"
+
+#endif // SPSCQUEUE_H
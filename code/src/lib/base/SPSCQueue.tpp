@@ -0,0 +1,152 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include "exceptions/BadArgumentException.h"
+
+/******************************************************************************/
+/* Constructors and Destructor                                                */
+/******************************************************************************/
+
+template <typename T>
+SPSCQueue<T>::SPSCQueue(size_t capacity) :
+    mHead(0),
+    mTailCache(0),
+    mTail(0),
+    mHeadCache(0) {
+  if (!capacity)
+    throw BadArgumentException<size_t>(capacity,
+      "SPSCQueue<T>::SPSCQueue(): capacity must be strictly positive",
+      __FILE__, __LINE__);
+  size_t size = 1;
+  while (size < capacity)
+    size *= 2;
+  mBuffer.resize(size);
+  mMask = size - 1;
+}
+
+template <typename T>
+SPSCQueue<T>::~SPSCQueue() {
+}
+
+/******************************************************************************/
+/* Accessors                                                                  */
+/******************************************************************************/
+
+template <typename T>
+size_t SPSCQueue<T>::getCapacity() const {
+  return mBuffer.size();
+}
+
+template <typename T>
+size_t SPSCQueue<T>::getSize() const {
+  return mTail - mHead;
+}
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+template <typename T>
+bool SPSCQueue<T>::enqueue(const T& value) {
+  const size_t tail = mTail;
+  if (tail - mHeadCache == mBuffer.size()) {
+    mHeadCache = mHead;
+    __sync_synchronize();
+    if (tail - mHeadCache == mBuffer.size())
+      return false;
+  }
+  mBuffer[tail & mMask] = value;
+  __sync_synchronize();
+  mTail = tail + 1;
+  return true;
+}
+
+template <typename T>
+bool SPSCQueue<T>::dequeue(T& value) {
+  const size_t head = mHead;
+  if (head == mTailCache) {
+    mTailCache = mTail;
+    __sync_synchronize();
+    if (head == mTailCache)
+      return false;
+  }
+  value = mBuffer[head & mMask];
+  __sync_synchronize();
+  mHead = head + 1;
+  return true;
+}
+
+template <typename T>
+bool SPSCQueue<T>::tryPush(const T& value) {
+  if (!enqueue(value))
+    return false;
+  mNotEmpty.signal();
+  return true;
+}
+
+template <typename T>
+bool SPSCQueue<T>::push(const T& value, double seconds) {
+  if (tryPush(value))
+    return true;
+  bool pushed = false;
+  const Clock::Nanoseconds deadline = QueueCondition::getDeadline(seconds);
+  mNotFull.lock();
+  for (;;) {
+    mNotFull.setWaiting();
+    if ((pushed = enqueue(value)))
+      break;
+    if (!mNotFull.waitUntil(deadline)) {
+      pushed = enqueue(value);
+      break;
+    }
+  }
+  mNotFull.unlock();
+  if (pushed)
+    mNotEmpty.signal();
+  return pushed;
+}
+
+template <typename T>
+bool SPSCQueue<T>::tryPop(T& value) {
+  if (!dequeue(value))
+    return false;
+  mNotFull.signal();
+  return true;
+}
+
+template <typename T>
+bool SPSCQueue<T>::pop(T& value, double seconds) {
+  if (tryPop(value))
+    return true;
+  bool popped = false;
+  const Clock::Nanoseconds deadline = QueueCondition::getDeadline(seconds);
+  mNotEmpty.lock();
+  for (;;) {
+    mNotEmpty.setWaiting();
+    if ((popped = dequeue(value)))
+      break;
+    if (!mNotEmpty.waitUntil(deadline)) {
+      popped = dequeue(value);
+      break;
+    }
+  }
+  mNotEmpty.unlock();
+  if (popped)
+    mNotFull.signal();
+  return popped;
+}
@@ -0,0 +1,55 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include "base/ScopedTimer.h"
+
+#include "base/Profiler.h"
+
+/******************************************************************************/
+/* Constructors and Destructor                                                */
+/******************************************************************************/
+
+ScopedTimer::ScopedTimer(const char* name) :
+    mHistogram(Profiler::getInstance().getHistogram(name)),
+    mStart(Clock::now()),
+    mStop(0) {
+}
+
+ScopedTimer::~ScopedTimer() {
+  stop();
+}
+
+/******************************************************************************/
+/* Accessors                                                                  */
+/******************************************************************************/
+
+double ScopedTimer::getElapsed() const {
+  return Clock::getSeconds((mStop ? mStop : Clock::now()) - mStart);
+}
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+double ScopedTimer::stop() {
+  if (!mStop) {
+    mStop = Clock::now();
+    mHistogram.add(mStop - mStart);
+  }
+  return Clock::getSeconds(mStop - mStart);
+}
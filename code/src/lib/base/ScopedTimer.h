@@ -0,0 +1,89 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file ScopedTimer.h
+    \brief This file defines the ScopedTimer class, which times a scope into a
+           profiler histogram
+  */
+
+#ifndef SCOPEDTIMER_H
+#define SCOPEDTIMER_H
+
+#include "base/Clock.h"
+
+class TimeHistogram;
+
+/** The class ScopedTimer measures the time from its construction to its
+    destruction, or to an explicit stop, on the monotonic clock and records it
+    into the calling thread's profiler histogram of the given name.
+    \brief Scope timer
+  */
+class ScopedTimer {
+  /** \name Private constructors
+    @{
+    */
+  /// Copy constructor
+  ScopedTimer(const ScopedTimer& other);
+  /// Assignment operator
+  ScopedTimer& operator = (const ScopedTimer& other);
+  /** @}
+    */
+
+public:
+  /** \name Constructors/Destructor
+    @{
+    */
+  /// Starts timing into the named histogram, name must be a static string
+  ScopedTimer(const char* name);
+  /// Destructor, records the time unless stopped
+  ~ScopedTimer();
+  /** @}
+    */
+
+  /** \name Accessors
+    @{
+    */
+  /// Returns the elapsed time in seconds, up to the stop if stopped
+  double getElapsed() const;
+  /** @}
+    */
+
+  /** \name Methods
+    @{
+    */
+  /// Stops and records the time once, returns the elapsed time in seconds
+  double stop();
+  /** @}
+    */
+
+protected:
+  /** \name Protected members
+    @{
+    */
+  /// Histogram recording the time
+  TimeHistogram& mHistogram;
+  /// Starting time
+  Clock::Nanoseconds mStart;
+  /// Stopping time, zero while running
+  Clock::Nanoseconds mStop;
+  /** @}
+    */
+
+};
+
+#endif // SCOPEDTIMER_H
@@ -19,10 +19,15 @@
 #include "base/Thread.h"
 
 #include <cmath>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
 
 #include "base/Threads.h"
+#include "base/Clock.h"
 #include "exceptions/SystemException.h"
 #include "exceptions/InvalidOperationException.h"
+#include "exceptions/BadArgumentException.h"
 
 #ifdef __NR_gettid
 static pid_t gettid (void) {
@@ -62,13 +67,82 @@ Thread::Identifier& Thread::Identifier::operator = (const Identifier& other) {
 Thread::Identifier::~Identifier() {
 }
 
+Thread::Placement::Placement() :
+    mPolicy(-1),
+    mPriority(0),
+    mCPU(-1) {
+  CPU_ZERO(&mAffinity);
+}
+
+Thread::Placement::Placement(const Placement& other) :
+    mPolicy(other.mPolicy),
+    mPriority(other.mPriority),
+    mAffinity(other.mAffinity),
+    mCPU(other.mCPU) {
+}
+
+Thread::Placement& Thread::Placement::operator = (const Placement& other) {
+  if (this != &other) {
+    mPolicy = other.mPolicy;
+    mPriority = other.mPriority;
+    mAffinity = other.mAffinity;
+    mCPU = other.mCPU;
+  }
+  return *this;
+}
+
+Thread::Placement::~Placement() {
+}
+
+Thread::Statistics::Statistics() {
+  reset();
+}
+
+Thread::Statistics::Statistics(const Statistics& other) :
+    mNumCycles(other.mNumCycles),
+    mNumMisses(other.mNumMisses),
+    mNumWakeups(other.mNumWakeups),
+    mMinLatency(other.mMinLatency),
+    mMaxLatency(other.mMaxLatency),
+    mSumLatency(other.mSumLatency),
+    mMaxJitter(other.mMaxJitter),
+    mSumJitter(other.mSumJitter) {
+  std::copy(other.mLatencyHistogram, other.mLatencyHistogram + numBins,
+    mLatencyHistogram);
+  std::copy(other.mJitterHistogram, other.mJitterHistogram + numBins,
+    mJitterHistogram);
+}
+
+Thread::Statistics& Thread::Statistics::operator = (const Statistics& other) {
+  if (this != &other) {
+    mNumCycles = other.mNumCycles;
+    mNumMisses = other.mNumMisses;
+    mNumWakeups = other.mNumWakeups;
+    mMinLatency = other.mMinLatency;
+    mMaxLatency = other.mMaxLatency;
+    mSumLatency = other.mSumLatency;
+    mMaxJitter = other.mMaxJitter;
+    mSumJitter = other.mSumJitter;
+    std::copy(other.mLatencyHistogram, other.mLatencyHistogram + numBins,
+      mLatencyHistogram);
+    std::copy(other.mJitterHistogram, other.mJitterHistogram + numBins,
+      mJitterHistogram);
+  }
+  return *this;
+}
+
+Thread::Statistics::~Statistics() {
+}
+
 Thread::Thread(double cycle, size_t stackSize) :
     mState(initialized),
     mCancel(false),
     mPriority(inherit),
+    mPolicy(inheritPolicy),
     mStackSize(stackSize),
     mCycle(cycle),
     mNumCycles(0) {
+  CPU_ZERO(&mAffinity);
 }
 
 Thread::~Thread() {
@@ -115,26 +189,124 @@ void Thread::setPriority(Priority priority) {
 
 void Thread::safeSetPriority(Priority priority) {
   mPriority = priority;
-  if ((mIdentifier.mPosix != 0) && (priority != inherit)) {
-    int policy;
-    SchedulingParameter param;
-    int ret = pthread_getschedparam(mIdentifier.mPosix, &policy, &param);
-    if (ret)
-      throw SystemException(ret,
-        "Thread::safeSetPriority()::pthread_getschedparam()");
-    if (!ret) {
-      const int minPriority = sched_get_priority_min(policy);
-      const int maxPriority = sched_get_priority_max(policy);
-      if ((minPriority != -1) && (maxPriority != -1)) {
-        param.sched_priority = minPriority +
-          round((maxPriority - minPriority) / critical * priority);
-        ret = pthread_setschedparam(mIdentifier.mPosix, policy, &param);
-        if (ret)
-          throw SystemException(ret,
-            "Thread::safeSetPriority()::pthread_setschedparam()");
-      }
-    }
+  safeSetScheduling();
+}
+
+Thread::Policy Thread::getPolicy() const {
+  Mutex::ScopedLock lock(mMutex);
+  return mPolicy;
+}
+
+void Thread::setPolicy(Policy policy) {
+  Mutex::ScopedLock lock(mMutex);
+  safeSetPolicy(policy);
+}
+
+void Thread::safeSetPolicy(Policy policy) {
+  mPolicy = policy;
+  safeSetScheduling();
+}
+
+void Thread::safeSetScheduling() {
+  if ((mIdentifier.mPosix == 0) ||
+      ((mPriority == inherit) && (mPolicy == inheritPolicy)))
+    return;
+  int policy;
+  SchedulingParameter param;
+  int ret = pthread_getschedparam(mIdentifier.mPosix, &policy, &param);
+  if (ret)
+    throw SystemException(ret,
+      "Thread::safeSetScheduling()::pthread_getschedparam()");
+  if (mPolicy == timeSharing)
+    policy = SCHED_OTHER;
+  else if (mPolicy == fifo)
+    policy = SCHED_FIFO;
+  else if (mPolicy == roundRobin)
+    policy = SCHED_RR;
+  const int minPriority = sched_get_priority_min(policy);
+  const int maxPriority = sched_get_priority_max(policy);
+  if ((minPriority == -1) || (maxPriority == -1))
+    return;
+  if (mPriority != inherit)
+    param.sched_priority = minPriority +
+      round((maxPriority - minPriority) / critical * mPriority);
+  else
+    param.sched_priority = std::min(std::max(param.sched_priority,
+      minPriority), maxPriority);
+  ret = pthread_setschedparam(mIdentifier.mPosix, policy, &param);
+  if (ret)
+    throw SystemException(ret,
+      "Thread::safeSetScheduling()::pthread_setschedparam()");
+}
+
+Thread::CPUSet Thread::getAffinity() const {
+  Mutex::ScopedLock lock(mMutex);
+  return mAffinity;
+}
+
+void Thread::setAffinity(const CPUSet& affinity) {
+  Mutex::ScopedLock lock(mMutex);
+  safeSetAffinity(affinity);
+}
+
+void Thread::setAffinity(size_t cpu) {
+  if (cpu >= CPU_SETSIZE)
+    throw BadArgumentException<size_t>(cpu,
+      "Thread::setAffinity(): invalid CPU", __FILE__, __LINE__);
+  CPUSet affinity;
+  CPU_ZERO(&affinity);
+  CPU_SET(cpu, &affinity);
+  setAffinity(affinity);
+}
+
+void Thread::safeSetAffinity(const CPUSet& affinity) {
+  mAffinity = affinity;
+  if (mIdentifier.mPosix == 0)
+    return;
+  CPUSet cpus = affinity;
+  if (!CPU_COUNT(&cpus))
+    for (size_t i = 0; i < CPU_SETSIZE; ++i)
+      CPU_SET(i, &cpus);
+  const int ret = pthread_setaffinity_np(mIdentifier.mPosix, sizeof(CPUSet),
+    &cpus);
+  if (ret)
+    throw SystemException(ret,
+      "Thread::safeSetAffinity()::pthread_setaffinity_np()");
+}
+
+Thread::Placement Thread::getPlacement() const {
+  Mutex::ScopedLock lock(mMutex);
+  Placement placement;
+  if (!safeExists())
+    return placement;
+  SchedulingParameter param;
+  int ret = pthread_getschedparam(mIdentifier.mPosix, &placement.mPolicy,
+    &param);
+  if (ret)
+    throw SystemException(ret,
+      "Thread::getPlacement()::pthread_getschedparam()");
+  placement.mPriority = param.sched_priority;
+  ret = pthread_getaffinity_np(mIdentifier.mPosix, sizeof(CPUSet),
+    &placement.mAffinity);
+  if (ret)
+    throw SystemException(ret,
+      "Thread::getPlacement()::pthread_getaffinity_np()");
+  std::ostringstream filename;
+  filename << "/proc/" << mIdentifier.mProcess << "/task/"
+    << mIdentifier.mKernel << "/stat";
+  std::ifstream statFile(filename.str().c_str());
+  std::string stat;
+  getline(statFile, stat);
+  const size_t pos = stat.rfind(')');
+  if (pos != std::string::npos) {
+    std::istringstream fields(stat.substr(pos + 1));
+    std::string field;
+    for (size_t i = 3; i < 39; ++i)
+      fields >> field;
+    if (!(fields >> placement.mCPU))
+      placement.mCPU = -1;
   }
+  return placement;
 }
 
 size_t Thread::getStackSize() const {
@@ -156,6 +328,24 @@ size_t Thread::getNumCycles() const {
   return mNumCycles;
 }
 
+double Thread::Statistics::getMeanLatency() const {
+  return mNumCycles ? mSumLatency / mNumCycles : 0.0;
+}
+
+double Thread::Statistics::getMeanJitter() const {
+  return mNumWakeups ? mSumJitter / mNumWakeups : 0.0;
+}
+
+Thread::Statistics Thread::getStatistics() const {
+  Mutex::ScopedLock lock(mMutex);
+  return mStatistics;
+}
+
+void Thread::resetStatistics() {
+  Mutex::ScopedLock lock(mMutex);
+  mStatistics.reset();
+}
+
 const Timer& Thread::getTimer() const {
   return mTimer;
 }
@@ -185,6 +375,56 @@ void Thread::Identifier::read(std::ifstream& stream) {
 void Thread::Identifier::write(std::ofstream& stream) const {
 }
 
+void Thread::Placement::read(std::istream& stream) {
+}
+
+void Thread::Placement::write(std::ostream& stream) const {
+  stream << "policy: " << ((mPolicy == SCHED_FIFO) ? "fifo" :
+    (mPolicy == SCHED_RR) ? "round-robin" : (mPolicy == -1) ? "none" :
+    "time-sharing") << std::endl
+    << "priority: " << mPriority << std::endl
+    << "affinity:";
+  for (size_t i = 0; i < CPU_SETSIZE; ++i)
+    if (CPU_ISSET(i, &mAffinity))
+      stream << " " << i;
+  stream << std::endl
+    << "cpu: " << mCPU;
+}
+
+void Thread::Placement::read(std::ifstream& stream) {
+}
+
+void Thread::Placement::write(std::ofstream& stream) const {
+}
+
+void Thread::Statistics::read(std::istream& stream) {
+}
+
+void Thread::Statistics::write(std::ostream& stream) const {
+  stream << "cycles: " << mNumCycles << std::endl
+    << "deadline misses: " << mNumMisses << std::endl
+    << "latency [s]: min " << (mNumCycles ? mMinLatency : 0.0)
+    << ", mean " << getMeanLatency() << ", max " << mMaxLatency << std::endl
+    << "jitter [s]: mean " << getMeanJitter() << ", max " << mMaxJitter
+    << std::endl
+    << "latency histogram [us]:";
+  for (size_t i = 0; i < numBins; ++i)
+    if (mLatencyHistogram[i])
+      stream << " " << (i ? (1ul << i) : 0) << "-" << (2ul << i) << ":"
+        << mLatencyHistogram[i];
+  stream << std::endl << "jitter histogram [us]:";
+  for (size_t i = 0; i < numBins; ++i)
+    if (mJitterHistogram[i])
+      stream << " " << (i ? (1ul << i) : 0) << "-" << (2ul << i) << ":"
+        << mJitterHistogram[i];
+}
+
+void Thread::Statistics::read(std::ifstream& stream) {
+}
+
+void Thread::Statistics::write(std::ofstream& stream) const {
+}
+
 /******************************************************************************/
 /* Methods                                                                    */
 /******************************************************************************/
@@ -215,6 +455,48 @@ void Thread::Identifier::reset() {
   mProcess = -1;
 }
 
+size_t Thread::Statistics::getBin(double seconds) {
+  size_t microseconds = fabs(seconds) * 1e6;
+  size_t bin = 0;
+  while ((microseconds >>= 1) && (bin + 1 < numBins))
+    ++bin;
+  return bin;
+}
+
+void Thread::Statistics::addLatency(double latency, double cycle) {
+  if (!mNumCycles || (latency < mMinLatency))
+    mMinLatency = latency;
+  if (latency > mMaxLatency)
+    mMaxLatency = latency;
+  mSumLatency += latency;
+  ++mLatencyHistogram[getBin(latency)];
+  if ((cycle > 0.0) && (latency > cycle))
+    ++mNumMisses;
+  ++mNumCycles;
+}
+
+void Thread::Statistics::addJitter(double jitter) {
+  jitter = fabs(jitter);
+  if (jitter > mMaxJitter)
+    mMaxJitter = jitter;
+  mSumJitter += jitter;
+  ++mJitterHistogram[getBin(jitter)];
+  ++mNumWakeups;
+}
+
+void Thread::Statistics::reset() {
+  mNumCycles = 0;
+  mNumMisses = 0;
+  mNumWakeups = 0;
+  mMinLatency = 0.0;
+  mMaxLatency = 0.0;
+  mSumLatency = 0.0;
+  mMaxJitter = 0.0;
+  mSumJitter = 0.0;
+  std::fill(mLatencyHistogram, mLatencyHistogram + numBins, 0);
+  std::fill(mJitterHistogram, mJitterHistogram + numBins, 0);
+}
+
 bool Thread::start(Priority priority, double wait) {
   Mutex::ScopedLock lock(mMutex);
   bool result = false;
@@ -237,7 +519,14 @@ bool Thread::start(Priority priority, double wait) {
         throw SystemException(ret,
           "Thread::start()::pthread_attr_setstacksize()");
     }
+    if (CPU_COUNT(&mAffinity)) {
+      ret = pthread_attr_setaffinity_np(&attr, sizeof(CPUSet), &mAffinity);
+      if (ret)
+        throw SystemException(ret,
+          "Thread::start()::pthread_attr_setaffinity_np()");
+    }
     mNumCycles = 0;
+    mStatistics.reset();
     State state = mState;
     safeSetState(starting);
     ret = pthread_create(&mIdentifier.mPosix, &attr, Thread::start, this);
@@ -328,13 +617,24 @@ void* Thread::run() {
   while (!mCancel || !mNumCycles) {
     mMutex.unlock();
     mTimer.start();
+    const Clock::Nanoseconds start = Clock::now();
     process();
+    const Clock::Nanoseconds end = Clock::now();
+    const double latency = Clock::getSeconds(end - start);
     mMutex.lock();
-    mTrigger.wait(mMutex, mTimer.getLeft(mCycle));
+    const double cycle = mCycle;
+    const bool timed = (cycle > 0.0);
+    bool triggered = false;
+    if (timed && (latency < cycle))
+      triggered = mTrigger.wait(mMutex, cycle - latency);
     mMutex.unlock();
+    const Clock::Nanoseconds wakeup = Clock::now();
     mTimer.stop();
     mMutex.lock();
     ++mNumCycles;
+    mStatistics.addLatency(latency, cycle);
+    if (timed && !triggered)
+      mStatistics.addJitter(Clock::getSeconds(wakeup - start) - cycle);
     if (mCycle < 0.0)
       break;
   }
@@ -25,6 +25,7 @@
 #define THREAD_H
 
 #include <pthread.h>
+#include <sched.h>
 
 #include "base/Timer.h"
 #include "base/Mutex.h"
@@ -55,6 +56,8 @@ public:
   typedef pthread_attr_t Attribute;
   /// Thread's scheduling parameter
   typedef sched_param SchedulingParameter;
+  /// Thread's set of CPUs
+  typedef cpu_set_t CPUSet;
   /// Thread state
   enum State {
     /// Thread initialized
@@ -93,6 +96,17 @@ public:
     /// Critical priority
     critical
   };
+  /// Thread scheduling policy
+  enum Policy {
+    /// Inherits policy
+    inheritPolicy,
+    /// Time-sharing policy (SCHED_OTHER)
+    timeSharing,
+    /// Real-time first-in first-out policy (SCHED_FIFO)
+    fifo,
+    /// Real-time round-robin policy (SCHED_RR)
+    roundRobin
+  };
   /// Thread identifier
   struct Identifier :
     public Serializable {
@@ -133,6 +147,90 @@ public:
     /// Writes to a file
     virtual void write(std::ofstream& stream) const;
   };
+  /// Thread placement as seen by the kernel
+  struct Placement :
+    public Serializable {
+  public:
+    /// Kernel scheduling policy, -1 if the thread does not exist
+    int mPolicy;
+    /// Kernel scheduling priority
+    int mPriority;
+    /// CPUs the thread may run on
+    CPUSet mAffinity;
+    /// CPU the thread last ran on, -1 if unknown
+    int mCPU;
+    /// Default constructor
+    Placement();
+    /// Copy constructor
+    Placement(const Placement& other);
+    /// Assignment operator
+    Placement& operator = (const Placement& other);
+    /// Destructor
+    virtual ~Placement();
+    /// Reads from standard input
+    virtual void read(std::istream& stream);
+    /// Writes to standard output
+    virtual void write(std::ostream& stream) const;
+    /// Reads from a file
+    virtual void read(std::ifstream& stream);
+    /// Writes to a file
+    virtual void write(std::ofstream& stream) const;
+  };
+  /// Thread cycle statistics
+  struct Statistics :
+    public Serializable {
+  public:
+    /// Number of histogram bins, bin i counts [2^i, 2^(i+1)) microseconds
+    static const size_t numBins = 32;
+    /// Number of cycles performed
+    size_t mNumCycles;
+    /// Number of cycles whose processing exceeded the cycle period
+    size_t mNumMisses;
+    /// Number of timed wake-ups, i.e., cycles with a measured jitter
+    size_t mNumWakeups;
+    /// Minimum processing latency in seconds
+    double mMinLatency;
+    /// Maximum processing latency in seconds
+    double mMaxLatency;
+    /// Sum of processing latencies in seconds
+    double mSumLatency;
+    /// Maximum absolute wake-up jitter in seconds
+    double mMaxJitter;
+    /// Sum of absolute wake-up jitters in seconds
+    double mSumJitter;
+    /// Histogram of processing latencies
+    size_t mLatencyHistogram[numBins];
+    /// Histogram of absolute wake-up jitters
+    size_t mJitterHistogram[numBins];
+    /// Default constructor
+    Statistics();
+    /// Copy constructor
+    Statistics(const Statistics& other);
+    /// Assignment operator
+    Statistics& operator = (const Statistics& other);
+    /// Destructor
+    virtual ~Statistics();
+    /// Returns the mean processing latency in seconds
+    double getMeanLatency() const;
+    /// Returns the mean absolute wake-up jitter in seconds
+    double getMeanJitter() const;
+    /// Returns the histogram bin of a duration in seconds
+    static size_t getBin(double seconds);
+    /// Records a cycle's processing latency against the cycle period
+    void addLatency(double latency, double cycle);
+    /// Records a cycle's wake-up jitter
+    void addJitter(double jitter);
+    /// Reset the statistics
+    void reset();
+    /// Reads from standard input
+    virtual void read(std::istream& stream);
+    /// Writes to standard output
+    virtual void write(std::ostream& stream) const;
+    /// Reads from a file
+    virtual void read(std::ifstream& stream);
+    /// Writes to a file
+    virtual void write(std::ofstream& stream) const;
+  };
 
   /** @}
     */
@@ -158,6 +256,18 @@ public:
   Priority getPriority() const;
   /// Sets the thread's priority
   void setPriority(Priority priority);
+  /// Access the thread's scheduling policy
+  Policy getPolicy() const;
+  /// Sets the thread's scheduling policy
+  void setPolicy(Policy policy);
+  /// Access the thread's CPU affinity, empty if unrestricted
+  CPUSet getAffinity() const;
+  /// Sets the thread's CPU affinity, empty for unrestricted
+  void setAffinity(const CPUSet& affinity);
+  /// Pins the thread to a single CPU
+  void setAffinity(size_t cpu);
+  /// Access the thread's effective placement
+  Placement getPlacement() const;
   /// Access the thread's stack size
   size_t getStackSize() const;
   /// Access the thread's cycle period in seconds
@@ -166,6 +276,10 @@ public:
   void setCycle(double cycle);
   /// Access the thread's number of cycles performed
   size_t getNumCycles() const;
+  /// Access the thread's cycle statistics
+  Statistics getStatistics() const;
+  /// Reset the thread's cycle statistics
+  void resetStatistics();
   /// Access the thread's timer
   const Timer& getTimer() const;
   /// Access the thread's trigger
@@ -203,6 +317,12 @@ protected:
   virtual State safeSetState(State state);
   /// Safely access the thread's priority
   virtual void safeSetPriority(Priority priority);
+  /// Safely access the thread's scheduling policy
+  virtual void safeSetPolicy(Policy policy);
+  /// Safely apply the scheduling policy and priority to the thread
+  virtual void safeSetScheduling();
+  /// Safely access the thread's CPU affinity
+  virtual void safeSetAffinity(const CPUSet& affinity);
   /// Run all thread operations
   virtual void* run();
   /// Do initialization
@@ -233,12 +353,18 @@ protected:
   bool mCancel;
   /// Threads' priority
   Priority mPriority;
+  /// Thread's scheduling policy
+  Policy mPolicy;
+  /// Thread's CPU affinity
+  CPUSet mAffinity;
   /// Thread's stack size
   size_t mStackSize;
   /// Thread's cycle
   double mCycle;
   /// Thread's number of cycles
   size_t mNumCycles;
+  /// Thread's cycle statistics
+  Statistics mStatistics;
   /// Mutex protecting the object
   mutable Mutex mMutex;
   /// Start condition
@@ -0,0 +1,139 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include "base/ThreadPool.h"
+
+#include <unistd.h>
+
+#include "exceptions/InvalidOperationException.h"
+
+/******************************************************************************/
+/* Constructors and Destructor                                                */
+/******************************************************************************/
+
+ThreadPool::Task::~Task() {
+}
+
+ThreadPool::Worker::Worker(ThreadPool& pool) :
+    mPool(pool),
+    mGeneration(0) {
+}
+
+ThreadPool::ThreadPool(size_t numThreads, bool pinWorkers) :
+    mTask(0),
+    mNumTasks(0),
+    mNextTask(0),
+    mNumDone(0),
+    mGeneration(0),
+    mFailed(false),
+    mShutdown(false) {
+  if (numThreads == 0)
+    numThreads = getNumCPUs();
+  mWorkers.reserve(numThreads - 1);
+  for (size_t i = 1; i < numThreads; ++i) {
+    mWorkers.push_back(new Worker(*this));
+    if (pinWorkers)
+      mWorkers.back()->setAffinity(i % getNumCPUs());
+    mWorkers.back()->start();
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  mMutex.lock();
+  mShutdown = true;
+  mWork.signal(Condition::broadcast);
+  mMutex.unlock();
+  for (auto it = mWorkers.begin(); it != mWorkers.end(); ++it) {
+    (*it)->interrupt();
+    delete *it;
+  }
+}
+
+/******************************************************************************/
+/* Accessors                                                                  */
+/******************************************************************************/
+
+size_t ThreadPool::getNumThreads() const {
+  return mWorkers.size() + 1;
+}
+
+size_t ThreadPool::getNumCPUs() {
+  const long numCPUs = sysconf(_SC_NPROCESSORS_ONLN);
+  return (numCPUs > 0) ? numCPUs : 1;
+}
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+void ThreadPool::process(Task& task, size_t numTasks) {
+  if (numTasks == 0)
+    return;
+  mMutex.lock();
+  mTask = &task;
+  mNumTasks = numTasks;
+  mNextTask = 0;
+  mNumDone = 0;
+  mFailed = false;
+  ++mGeneration;
+  mWork.signal(Condition::broadcast);
+  mMutex.unlock();
+  while (processNext());
+  mMutex.lock();
+  while (mNumDone != mNumTasks)
+    mDone.wait(mMutex);
+  mTask = 0;
+  const bool failed = mFailed;
+  mMutex.unlock();
+  if (failed)
+    throw InvalidOperationException("ThreadPool::process(): task failed");
+}
+
+bool ThreadPool::processNext() {
+  mMutex.lock();
+  if (mNextTask >= mNumTasks) {
+    mMutex.unlock();
+    return false;
+  }
+  const size_t index = mNextTask++;
+  Task* task = mTask;
+  mMutex.unlock();
+  bool failed = false;
+  try {
+    task->process(index);
+  }
+  catch (...) {
+    failed = true;
+  }
+  Mutex::ScopedLock lock(mMutex);
+  mFailed |= failed;
+  if (++mNumDone == mNumTasks)
+    mDone.signal(Condition::broadcast);
+  return true;
+}
+
+void ThreadPool::Worker::process() {
+  mPool.mMutex.lock();
+  while (!mPool.mShutdown && (mGeneration == mPool.mGeneration))
+    mPool.mWork.wait(mPool.mMutex);
+  const bool shutdown = mPool.mShutdown;
+  mGeneration = mPool.mGeneration;
+  mPool.mMutex.unlock();
+  if (!shutdown)
+    while (mPool.processNext());
+}
@@ -0,0 +1,156 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file ThreadPool.h
+    \brief This file defines the ThreadPool class, which provides a pool of
+           worker threads for parallel loops
+  */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+
+#include "base/Thread.h"
+#include "base/Mutex.h"
+#include "base/Condition.h"
+
+/** The class ThreadPool implements a pool of worker threads processing the
+    indexed tasks of a parallel loop. The calling thread takes part in the
+    processing, so a pool of one thread runs everything serially.
+    \brief Pool of worker threads
+  */
+class ThreadPool {
+  /** \name Private constructors
+    @{
+    */
+  /// Copy constructor
+  ThreadPool(const ThreadPool& other);
+  /// Assignment operator
+  ThreadPool& operator = (const ThreadPool& other);
+  /** @}
+    */
+
+public:
+  /** \name Types definitions
+    @{
+    */
+  /// Task interface for the parallel loop
+  class Task {
+  public:
+    /// Destructor
+    virtual ~Task();
+    /// Process the task with the given index
+    virtual void process(size_t index) = 0;
+  };
+  /** @}
+    */
+
+  /** \name Constructors/Destructor
+    @{
+    */
+  /// Constructs pool with the number of threads (0 means one per CPU),
+  /// optionally pinning the i-th worker thread to the i-th CPU
+  ThreadPool(size_t numThreads = 0, bool pinWorkers = false);
+  /// Destructor
+  virtual ~ThreadPool();
+  /** @}
+    */
+
+  /** \name Accessors
+    @{
+    */
+  /// Access the number of threads, including the calling thread
+  size_t getNumThreads() const;
+  /// Access the number of online CPUs
+  static size_t getNumCPUs();
+  /** @}
+    */
+
+  /** \name Methods
+    @{
+    */
+  /// Process the tasks [0, numTasks) and block until all are done
+  void process(Task& task, size_t numTasks);
+  /// Reduce partial results pairwise in a fixed order into the first one
+  template <typename T> static void reduce(std::vector<T>& partials);
+  /** @}
+    */
+
+protected:
+  /** \name Protected types
+    @{
+    */
+  /// Worker thread of the pool
+  class Worker :
+    public Thread {
+  public:
+    /// Constructs worker for a pool
+    Worker(ThreadPool& pool);
+  protected:
+    /// Wait for tasks and process them
+    virtual void process();
+    /// Pool of the worker
+    ThreadPool& mPool;
+    /// Generation of tasks last seen by the worker
+    size_t mGeneration;
+  };
+  /** @}
+    */
+
+  /** \name Protected methods
+    @{
+    */
+  /// Process the next pending task / Returns false if none is left
+  bool processNext();
+  /** @}
+    */
+
+  /** \name Protected members
+    @{
+    */
+  /// Worker threads
+  std::vector<Worker*> mWorkers;
+  /// Current task
+  Task* mTask;
+  /// Number of tasks
+  size_t mNumTasks;
+  /// Next task index to be processed
+  size_t mNextTask;
+  /// Number of tasks processed
+  size_t mNumDone;
+  /// Generation of tasks, incremented for each parallel loop
+  size_t mGeneration;
+  /// Failure flag of the current loop
+  bool mFailed;
+  /// Shutdown flag
+  bool mShutdown;
+  /// Mutex protecting the object
+  mutable Mutex mMutex;
+  /// Work available condition
+  Condition mWork;
+  /// Work done condition
+  Condition mDone;
+  /** @}
+    */
+
+};
+
+#include "base/ThreadPool.tpp"
+
+#endif // THREADPOOL_H
@@ -17,6 +17,9 @@
  ******************************************************************************/
 
 #include "base/Threads.h"
+
+#include <vector>
+
 #include "exceptions/SystemException.h"
 #include "exceptions/ThreadsManagerException.h"
 
@@ -74,6 +77,52 @@ Thread& Threads::get(const Thread::Identifier& identifier) const {
       "Threads::get(): thread not registered");
 }
 
+std::map<Thread::Identifier, Thread::Placement> Threads::getPlacements()
+    const {
+  std::vector<Thread*> threads;
+  int ret = pthread_mutex_lock(&mMutex);
+  if (ret)
+    throw SystemException(ret,
+      "Threads::getPlacements()::pthread_mutex_lock()");
+  threads.reserve(mInstances.size());
+  for (auto it = mInstances.begin(); it != mInstances.end(); ++it)
+    threads.push_back(it->second);
+  ret = pthread_mutex_unlock(&mMutex);
+  if (ret)
+    throw SystemException(ret,
+      "Threads::getPlacements()::pthread_mutex_unlock()");
+  std::map<Thread::Identifier, Thread::Placement> placements;
+  for (auto it = threads.begin(); it != threads.end(); ++it) {
+    const Thread::Identifier identifier = (*it)->getIdentifier();
+    if (identifier)
+      placements[identifier] = (*it)->getPlacement();
+  }
+  return placements;
+}
+
+std::map<Thread::Identifier, Thread::Statistics> Threads::getStatistics()
+    const {
+  std::vector<Thread*> threads;
+  int ret = pthread_mutex_lock(&mMutex);
+  if (ret)
+    throw SystemException(ret,
+      "Threads::getStatistics()::pthread_mutex_lock()");
+  threads.reserve(mInstances.size());
+  for (auto it = mInstances.begin(); it != mInstances.end(); ++it)
+    threads.push_back(it->second);
+  ret = pthread_mutex_unlock(&mMutex);
+  if (ret)
+    throw SystemException(ret,
+      "Threads::getStatistics()::pthread_mutex_unlock()");
+  std::map<Thread::Identifier, Thread::Statistics> statistics;
+  for (auto it = threads.begin(); it != threads.end(); ++it) {
+    const Thread::Identifier identifier = (*it)->getIdentifier();
+    if (identifier)
+      statistics[identifier] = (*it)->getStatistics();
+  }
+  return statistics;
+}
+
 /******************************************************************************/
 /* Methods                                                                    */
 /******************************************************************************/
@@ -56,6 +56,10 @@ public:
   Thread& getSelf() const;
   /// Access the thread object associated with the specified identifier
   Thread& get(const Thread::Identifier& identifier) const;
+  /// Access the effective placement of all registered thread objects
+  std::map<Thread::Identifier, Thread::Placement> getPlacements() const;
+  /// Access the cycle statistics of all registered thread objects
+  std::map<Thread::Identifier, Thread::Statistics> getStatistics() const;
   /** @}
     */
 
@@ -0,0 +1,169 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include "base/TimeHistogram.h"
+
+#include <algorithm>
+#include <limits>
+
+/******************************************************************************/
+/* Statics                                                                    */
+/******************************************************************************/
+
+template <typename T> static T load(const T& value) {
+  return __sync_fetch_and_add(const_cast<T*>(&value), 0);
+}
+
+/******************************************************************************/
+/* Constructors and Destructor                                                */
+/******************************************************************************/
+
+TimeHistogram::TimeHistogram() {
+  reset();
+}
+
+TimeHistogram::TimeHistogram(const TimeHistogram& other) {
+  reset();
+  merge(other);
+}
+
+TimeHistogram& TimeHistogram::operator = (const TimeHistogram& other) {
+  if (this != &other) {
+    reset();
+    merge(other);
+  }
+  return *this;
+}
+
+TimeHistogram::~TimeHistogram() {
+}
+
+/******************************************************************************/
+/* Stream operations                                                          */
+/******************************************************************************/
+
+void TimeHistogram::read(std::istream& stream) {
+}
+
+void TimeHistogram::write(std::ostream& stream) const {
+  stream << "samples: " << getNumSamples() << ", total: " << getTotal()
+    << ", mean: " << getMean() << ", min: " << getMin() << ", max: "
+    << getMax() << ", p50: " << getQuantile(0.5) << ", p99: "
+    << getQuantile(0.99) << " [s]";
+}
+
+void TimeHistogram::read(std::ifstream& stream) {
+}
+
+void TimeHistogram::write(std::ofstream& stream) const {
+  stream << getNumSamples() << " " << getTotal() << " " << getMin() << " "
+    << getMax();
+  for (size_t i = 0; i < numBins; ++i)
+    stream << " " << getBinCount(i);
+  stream << std::endl;
+}
+
+/******************************************************************************/
+/* Accessors                                                                  */
+/******************************************************************************/
+
+size_t TimeHistogram::getNumSamples() const {
+  return load(mNumSamples);
+}
+
+double TimeHistogram::getTotal() const {
+  return Clock::getSeconds(load(mTotal));
+}
+
+double TimeHistogram::getMean() const {
+  const size_t numSamples = getNumSamples();
+  return numSamples ? getTotal() / numSamples : 0.0;
+}
+
+double TimeHistogram::getMin() const {
+  return getNumSamples() ? Clock::getSeconds(load(mMin)) : 0.0;
+}
+
+double TimeHistogram::getMax() const {
+  return Clock::getSeconds(load(mMax));
+}
+
+double TimeHistogram::getQuantile(double quantile) const {
+  const size_t numSamples = getNumSamples();
+  if (!numSamples)
+    return 0.0;
+  size_t count = 0;
+  for (size_t i = 0; i < numBins; ++i) {
+    count += getBinCount(i);
+    if ((count >= quantile * numSamples) && (i + 1 < numBins))
+      return std::min(Clock::getSeconds((Clock::Nanoseconds)2 << i),
+        getMax());
+  }
+  return getMax();
+}
+
+size_t TimeHistogram::getBinCount(size_t bin) const {
+  return load(mBins[bin]);
+}
+
+size_t TimeHistogram::getBin(Clock::Nanoseconds duration) {
+  size_t bin = 0;
+  while ((duration >>= 1) && (bin + 1 < numBins))
+    ++bin;
+  return bin;
+}
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+void TimeHistogram::add(Clock::Nanoseconds duration) {
+  __sync_fetch_and_add(&mBins[getBin(duration)], 1);
+  __sync_fetch_and_add(&mTotal, duration);
+  __sync_fetch_and_add(&mNumSamples, 1);
+  Clock::Nanoseconds min = mMin;
+  while (duration < min)
+    min = __sync_val_compare_and_swap(&mMin, min, duration);
+  Clock::Nanoseconds max = mMax;
+  while (duration > max)
+    max = __sync_val_compare_and_swap(&mMax, max, duration);
+}
+
+void TimeHistogram::merge(const TimeHistogram& other) {
+  for (size_t i = 0; i < numBins; ++i)
+    __sync_fetch_and_add(&mBins[i], other.getBinCount(i));
+  __sync_fetch_and_add(&mTotal, load(other.mTotal));
+  __sync_fetch_and_add(&mNumSamples, other.getNumSamples());
+  const Clock::Nanoseconds otherMin = load(other.mMin);
+  Clock::Nanoseconds min = mMin;
+  while (otherMin < min)
+    min = __sync_val_compare_and_swap(&mMin, min, otherMin);
+  const Clock::Nanoseconds otherMax = load(other.mMax);
+  Clock::Nanoseconds max = mMax;
+  while (otherMax > max)
+    max = __sync_val_compare_and_swap(&mMax, max, otherMax);
+}
+
+void TimeHistogram::reset() {
+  mNumSamples = 0;
+  mTotal = 0;
+  mMin = std::numeric_limits<Clock::Nanoseconds>::max();
+  mMax = 0;
+  for (size_t i = 0; i < numBins; ++i)
+    mBins[i] = 0;
+}
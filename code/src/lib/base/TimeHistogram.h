@@ -0,0 +1,130 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file TimeHistogram.h
+    \brief This file defines the TimeHistogram class, which accumulates
+           measured durations
+  */
+
+#ifndef TIMEHISTOGRAM_H
+#define TIMEHISTOGRAM_H
+
+#include <cstddef>
+
+#include "base/Clock.h"
+#include "base/Serializable.h"
+
+/** The class TimeHistogram accumulates durations into logarithmic bins, bin i
+    counting the durations in [2^i, 2^(i+1)) nanoseconds. Samples are added
+    with atomic operations, so that one thread may record while others read
+    or merge the histogram without locking.
+    \brief Histogram of measured durations
+  */
+class TimeHistogram :
+  public virtual Serializable {
+public:
+  /** \name Constants
+    @{
+    */
+  /// Number of bins
+  static const size_t numBins = 64;
+  /** @}
+    */
+
+  /** \name Constructors/Destructor
+    @{
+    */
+  /// Default constructor
+  TimeHistogram();
+  /// Copy constructor
+  TimeHistogram(const TimeHistogram& other);
+  /// Assignment operator
+  TimeHistogram& operator = (const TimeHistogram& other);
+  /// Destructor
+  virtual ~TimeHistogram();
+  /** @}
+    */
+
+  /** \name Accessors
+    @{
+    */
+  /// Returns the number of samples
+  size_t getNumSamples() const;
+  /// Returns the total duration in seconds
+  double getTotal() const;
+  /// Returns the mean duration in seconds
+  double getMean() const;
+  /// Returns the minimum duration in seconds
+  double getMin() const;
+  /// Returns the maximum duration in seconds
+  double getMax() const;
+  /// Returns an upper bound on the given quantile of durations in seconds
+  double getQuantile(double quantile) const;
+  /// Returns the number of samples in a bin
+  size_t getBinCount(size_t bin) const;
+  /// Returns the bin of a duration
+  static size_t getBin(Clock::Nanoseconds duration);
+  /** @}
+    */
+
+  /** \name Methods
+    @{
+    */
+  /// Adds a duration
+  void add(Clock::Nanoseconds duration);
+  /// Merges another histogram into this one
+  void merge(const TimeHistogram& other);
+  /// Reset the histogram
+  void reset();
+  /** @}
+    */
+
+protected:
+  /** \name Stream methods
+    @{
+    */
+  /// Reads from standard input
+  virtual void read(std::istream& stream);
+  /// Writes to standard output
+  virtual void write(std::ostream& stream) const;
+  /// Reads from a file
+  virtual void read(std::ifstream& stream);
+  /// Writes to a file
+  virtual void write(std::ofstream& stream) const;
+  /** @}
+    */
+
+  /** \name Protected members
+    @{
+    */
+  /// Number of samples
+  size_t mNumSamples;
+  /// Total duration
+  Clock::Nanoseconds mTotal;
+  /// Minimum duration
+  Clock::Nanoseconds mMin;
+  /// Maximum duration
+  Clock::Nanoseconds mMax;
+  /// Bins counts
+  size_t mBins[numBins];
+  /** @}
+    */
+
+};
+
+#endif // TIMEHISTOGRAM_H
@@ -29,10 +29,12 @@
 #include "base/Serializable.h"
 
 /** The class Component represents a graph component, i.e., a collection of
-    vertices and some property.
+    vertices and some property. The vertices are stored with the allocator
+    A.
     \brief A graph component
   */
-template <typename V, typename P> class Component :
+template <typename V, typename P, typename A = std::allocator<V> >
+  class Component :
   public virtual Serializable {
 public:
   /** \name Types definitions
@@ -42,8 +44,10 @@ public:
   typedef V VertexDescriptor;
   /// Component property
   typedef P Property;
+  /// Vertex allocator
+  typedef A Allocator;
   /// Container type
-  typedef std::vector<V> Container;
+  typedef std::vector<V, A> Container;
   /// Constant vertex iterator
   typedef typename Container::const_iterator ConstVertexIterator;
   /// Vertex iterator
@@ -54,10 +58,11 @@ public:
   /** \name Constructors/destructor
     @{
     */
-  /// Constructor with one vertex and property parameter
-  Component(const V& vertex, const P& property = P(0));
-  /// Constructor with property parameter
-  Component(const P& property = P(0));
+  /// Constructor with one vertex, property, and allocator parameter
+  Component(const V& vertex, const P& property = P(0),
+    const A& allocator = A());
+  /// Constructor with property and allocator parameter
+  Component(const P& property = P(0), const A& allocator = A());
   /// Copy constructor
   Component(const Component& other);
   /// Assignment operator
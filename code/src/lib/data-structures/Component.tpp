@@ -20,25 +20,28 @@
 /* Constructors and Destructor                                                */
 /******************************************************************************/
 
-template <typename V, typename P>
-Component<V, P>::Component(const V& vertex, const P& property) :
+template <typename V, typename P, typename A>
+Component<V, P, A>::Component(const V& vertex, const P& property,
+    const A& allocator) :
+    mVertices(allocator),
     mProperty(property) {
   mVertices.push_back(vertex);
 }
 
-template <typename V, typename P>
-Component<V, P>::Component(const P& property) :
+template <typename V, typename P, typename A>
+Component<V, P, A>::Component(const P& property, const A& allocator) :
+    mVertices(allocator),
     mProperty(property) {
 }
 
-template <typename V, typename P>
-Component<V, P>::Component(const Component& other) :
+template <typename V, typename P, typename A>
+Component<V, P, A>::Component(const Component& other) :
     mVertices(other.mVertices),
     mProperty(other.mProperty) {
 }
 
-template <typename V, typename P>
-Component<V, P>& Component<V, P>::operator = (const Component& other) {
+template <typename V, typename P, typename A>
+Component<V, P, A>& Component<V, P, A>::operator = (const Component& other) {
   if (this != &other) {
     mVertices = other.mVertices;
     mProperty = other.mProperty;
@@ -46,98 +49,100 @@ Component<V, P>& Component<V, P>::operator = (const Component& other) {
   return *this;
 }
 
-template <typename V, typename P>
-Component<V, P>::~Component() {
+template <typename V, typename P, typename A>
+Component<V, P, A>::~Component() {
 }
 
 /******************************************************************************/
 /* Stream operations                                                          */
 /******************************************************************************/
 
-template <typename V, typename P>
-void Component<V, P>::read(std::istream& stream) {
+template <typename V, typename P, typename A>
+void Component<V, P, A>::read(std::istream& stream) {
 }
 
-template <typename V, typename P>
-void Component<V, P>::write(std::ostream& stream) const {
+template <typename V, typename P, typename A>
+void Component<V, P, A>::write(std::ostream& stream) const {
   stream << "vertices: " << std::endl;
   for (ConstVertexIterator it = getVertexBegin(); it != getVertexEnd(); ++it)
     stream << *it << std::endl;
   stream << "property: " << mProperty;
 }
 
-template <typename V, typename P>
-void Component<V, P>::read(std::ifstream& stream) {
+template <typename V, typename P, typename A>
+void Component<V, P, A>::read(std::ifstream& stream) {
 }
 
-template <typename V, typename P>
-void Component<V, P>::write(std::ofstream& stream) const {
+template <typename V, typename P, typename A>
+void Component<V, P, A>::write(std::ofstream& stream) const {
 }
 
 /******************************************************************************/
 /* Accessors                                                                  */
 /******************************************************************************/
 
-template <typename V, typename P>
-void Component<V, P>::insertVertex(const V& vertex) {
+template <typename V, typename P, typename A>
+void Component<V, P, A>::insertVertex(const V& vertex) {
   mVertices.push_back(vertex);
 }
 
-template <typename V, typename P>
-void Component<V, P>::merge(const Component<V, P>& other) {
+template <typename V, typename P, typename A>
+void Component<V, P, A>::merge(const Component<V, P, A>& other) {
   mVertices.insert(getVertexEnd(), other.getVertexBegin(),
     other.getVertexEnd());
 }
 
-template <typename V, typename P>
-void Component<V, P>::clear() {
+template <typename V, typename P, typename A>
+void Component<V, P, A>::clear() {
   mVertices.clear();
 }
 
-template <typename V, typename P>
-size_t Component<V, P>::getNumVertices() const {
+template <typename V, typename P, typename A>
+size_t Component<V, P, A>::getNumVertices() const {
   return mVertices.size();
 }
 
-template <typename V, typename P>
-void Component<V, P>::setProperty(const P& property) {
+template <typename V, typename P, typename A>
+void Component<V, P, A>::setProperty(const P& property) {
   mProperty = property;
 }
 
-template <typename V, typename P>
-const P& Component<V, P>::getProperty() const {
+template <typename V, typename P, typename A>
+const P& Component<V, P, A>::getProperty() const {
   return mProperty;
 }
 
-template <typename V, typename P>
-P& Component<V, P>::getProperty() {
+template <typename V, typename P, typename A>
+P& Component<V, P, A>::getProperty() {
   return mProperty;
 }
 
-template <typename V, typename P>
-typename Component<V, P>::ConstVertexIterator Component<V, P>::getVertexBegin()
-    const {
+template <typename V, typename P, typename A>
+typename Component<V, P, A>::ConstVertexIterator
+    Component<V, P, A>::getVertexBegin() const {
   return mVertices.begin();
 }
 
-template <typename V, typename P>
-typename Component<V, P>::VertexIterator Component<V, P>::getVertexBegin() {
+template <typename V, typename P, typename A>
+typename Component<V, P, A>::VertexIterator
+    Component<V, P, A>::getVertexBegin() {
   return mVertices.begin();
 }
 
-template <typename V, typename P>
-typename Component<V, P>::ConstVertexIterator Component<V, P>::getVertexEnd()
-    const {
+template <typename V, typename P, typename A>
+typename Component<V, P, A>::ConstVertexIterator
+    Component<V, P, A>::getVertexEnd() const {
   return mVertices.end();
 }
 
-template <typename V, typename P>
-typename Component<V, P>::VertexIterator Component<V, P>::getVertexEnd() {
+template <typename V, typename P, typename A>
+typename Component<V, P, A>::VertexIterator
+    Component<V, P, A>::getVertexEnd() {
   return mVertices.end();
 }
 
-template <typename V, typename P>
-const typename Component<V, P>::Container& Component<V, P>::getVertices()
+template <typename V, typename P, typename A>
+const typename Component<V, P, A>::Container& Component<V, P, A>::getVertices()
     const {
   return mVertices;
 }
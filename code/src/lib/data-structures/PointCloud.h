@@ -30,6 +30,9 @@
 
 #include "base/Serializable.h"
 
+class BinaryReader;
+class BinaryWriter;
+
 /** The class PointCloud represents a point cloud, i.e., a group of n-d points.
     \brief A point cloud
   */
@@ -103,6 +106,10 @@ public:
   void writeBinary(std::ostream& stream) const;
   /// Reads from an input stream
   void readBinary(std::istream& stream);
+  /// Writes into a binary writer
+  void writeBinary(BinaryWriter& binaryWriter) const;
+  /// Reads from a binary reader, appending the points
+  void readBinary(BinaryReader& binaryReader);
   /** @}
     */
 
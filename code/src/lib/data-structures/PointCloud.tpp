@@ -172,23 +172,46 @@ void PointCloud<X, M>::reserve(size_t numPoints) {
 template <typename X, size_t M>
 void PointCloud<X, M>::writeBinary(std::ostream& stream) const {
   BinaryStreamWriter<std::ostream> binaryStream(stream);
+  writeBinary(binaryStream);
+}
+
+template <typename X, size_t M>
+void PointCloud<X, M>::readBinary(std::istream& stream) {
+  BinaryStreamReader<std::istream> binaryStream(stream);
+  readBinary(binaryStream);
+}
+
+template <typename X, size_t M>
+void PointCloud<X, M>::writeBinary(BinaryWriter& binaryWriter) const {
   const size_t numPoints = mPoints.size();
-  binaryStream << numPoints;
+  binaryWriter << numPoints;
+  if (sizeof(Point) == M * sizeof(X)) {
+    if (numPoints)
+      binaryWriter.writeArray(mPoints[0].data(), numPoints * M);
+    return;
+  }
   for (auto it = getPointBegin(); it != getPointEnd(); ++it)
     for (size_t i = 0; i < M; ++i)
-      binaryStream << (*it)(i);
+      binaryWriter << (*it)(i);
 }
 
 template <typename X, size_t M>
-void PointCloud<X, M>::readBinary(std::istream& stream) {
-  BinaryStreamReader<std::istream> binaryStream(stream);
+void PointCloud<X, M>::readBinary(BinaryReader& binaryReader) {
   size_t numPoints;
-  binaryStream >> numPoints;
+  binaryReader >> numPoints;
+  if (sizeof(Point) == M * sizeof(X)) {
+    const size_t offset = mPoints.size();
+    mPoints.resize(offset + numPoints);
+    if (numPoints)
+      binaryReader.readArray(mPoints[offset].data(), numPoints * M);
+    return;
+  }
+  mPoints.reserve(mPoints.size() + numPoints);
   for (size_t i = 0; i < numPoints; ++i) {
     Point point;
     for (size_t j = 0; j < M; ++j) {
       X value;
-      binaryStream >> value;
+      binaryReader >> value;
       point(j) = value;
     }
     mPoints.push_back(point);
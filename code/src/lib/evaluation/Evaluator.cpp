@@ -19,36 +19,49 @@
 #include "evaluation/Evaluator.h"
 
 #include <sstream>
-#include <set>
-#include <map>
-
-#include <QVector>
-#include <QPoint>
-#include <QPolygon>
+#include <algorithm>
+#include <cmath>
 
 #include "data-structures/Grid.h"
 #include "data-structures/Cell.h"
 #include "data-structures/DEMGraph.h"
 
+/******************************************************************************/
+/* Statics                                                                    */
+/******************************************************************************/
+
+const size_t Evaluator::noClass;
+
 /******************************************************************************/
 /* Constructors and Destructor                                                */
 /******************************************************************************/
 
-Evaluator::Evaluator() {
+Evaluator::Evaluator() :
+    mLabelMapOrigin(Eigen::Matrix<double, 2, 1>::Zero()),
+    mLabelMapAxes(Eigen::Matrix<double, 2, 2>::Zero()),
+    mLabelMapNumCells(Eigen::Matrix<size_t, 2, 1>::Zero()) {
 }
 
-Evaluator::Evaluator(const Evaluator& other) {
+Evaluator::Evaluator(const Evaluator& other) :
+    mClasses(other.mClasses),
+    mLabelMap(other.mLabelMap),
+    mLabelMapOrigin(other.mLabelMapOrigin),
+    mLabelMapAxes(other.mLabelMapAxes),
+    mLabelMapNumCells(other.mLabelMapNumCells) {
 }
 
 Evaluator& Evaluator::operator = (const Evaluator& other) {
   if (this != &other) {
+    mClasses = other.mClasses;
+    mLabelMap = other.mLabelMap;
+    mLabelMapOrigin = other.mLabelMapOrigin;
+    mLabelMapAxes = other.mLabelMapAxes;
+    mLabelMapNumCells = other.mLabelMapNumCells;
   }
   return *this;
 }
 
 Evaluator::~Evaluator() {
-  for (auto it = mClasses.begin(); it != mClasses.end(); ++it)
-    delete *it;
 }
 
 /******************************************************************************/
@@ -64,7 +77,7 @@ void Evaluator::write(std::ostream& stream) const {
 void Evaluator::read(std::ifstream& stream) throw (IOException) {
   if (stream.is_open() == false)
     throw IOException("Evaluator::read(): could not open file");
-  QVector<QPoint> polygon;
+  std::vector<double> vertices;
   clear();
   while (stream.eof() == false) {
     std::string line;
@@ -73,11 +86,17 @@ void Evaluator::read(std::ifstream& stream) throw (IOException) {
       std::stringstream lineStream(line);
       int x, y;
       lineStream >> x >> y;
-      polygon.push_back(QPoint(x, y));
+      vertices.push_back(x / 1000.0);
+      vertices.push_back(y / 1000.0);
     }
     else {
-      mClasses.push_back(new QRegion(QPolygon(polygon)));
-      polygon.clear();
+      Polygon polygon(vertices.size() / 2, 2);
+      for (size_t i = 0; i < static_cast<size_t>(polygon.rows()); ++i) {
+        polygon(i, 0) = vertices[2 * i];
+        polygon(i, 1) = vertices[2 * i + 1];
+      }
+      mClasses.push_back(polygon);
+      vertices.clear();
     }
   }
 }
@@ -93,98 +112,230 @@ void Evaluator::write(std::ofstream& stream) const {
 /* Methods                                                                    */
 /******************************************************************************/
 
-double Evaluator::computeVMeasure(const
-  Eigen::Matrix<size_t, Eigen::Dynamic, Eigen::Dynamic>& contingencyTable,
-  double beta) const {
-  double condEntropy = 0;
-  for (size_t i = 0; i < static_cast<size_t>(contingencyTable.cols()); ++i) {
-    const size_t columnSum = contingencyTable.col(i).sum();
-    for (size_t j = 0; j < static_cast<size_t>(contingencyTable.rows()); ++j)
-      if (contingencyTable(j, i))
-        condEntropy += (double)contingencyTable(j, i) / contingencyTable.sum() *
-          log((double)contingencyTable(j, i) / columnSum);
+void Evaluator::computeClusteringMetrics(const
+    Eigen::Matrix<size_t, Eigen::Dynamic, Eigen::Dynamic>& contingencyTable,
+    double beta, Metrics& metrics) const {
+  const size_t numClasses = contingencyTable.rows();
+  const size_t numLabels = contingencyTable.cols();
+  std::vector<double> classSums(numClasses, 0.0);
+  std::vector<double> labelSums(numLabels, 0.0);
+  std::vector<size_t> majorityLabels(numClasses, 0);
+  double total = 0.0;
+  double sumNLogN = 0.0;
+  double sumPairs = 0.0;
+  for (size_t j = 0; j < numLabels; ++j)
+    for (size_t i = 0; i < numClasses; ++i) {
+      const double count = contingencyTable(i, j);
+      if (!count)
+        continue;
+      classSums[i] += count;
+      labelSums[j] += count;
+      total += count;
+      sumNLogN += count * log(count);
+      sumPairs += count * (count - 1.0) / 2.0;
+      if (contingencyTable(i, j) > contingencyTable(i, majorityLabels[i]))
+        majorityLabels[i] = j;
+    }
+  double classNLogN = 0.0;
+  double classPairs = 0.0;
+  for (size_t i = 0; i < numClasses; ++i)
+    if (classSums[i]) {
+      classNLogN += classSums[i] * log(classSums[i]);
+      classPairs += classSums[i] * (classSums[i] - 1.0) / 2.0;
+    }
+  double labelNLogN = 0.0;
+  double labelPairs = 0.0;
+  for (size_t j = 0; j < numLabels; ++j)
+    if (labelSums[j]) {
+      labelNLogN += labelSums[j] * log(labelSums[j]);
+      labelPairs += labelSums[j] * (labelSums[j] - 1.0) / 2.0;
+    }
+  metrics.mHomogeneity = 1.0;
+  metrics.mCompleteness = 1.0;
+  if (total) {
+    const double classEntropy = log(total) - classNLogN / total;
+    const double labelEntropy = log(total) - labelNLogN / total;
+    if (classEntropy > 0.0)
+      metrics.mHomogeneity = 1.0 - (labelNLogN - sumNLogN) / total /
+        classEntropy;
+    if (labelEntropy > 0.0)
+      metrics.mCompleteness = 1.0 - (classNLogN - sumNLogN) / total /
+        labelEntropy;
   }
-  condEntropy *= -1.0;
-  double entropy = 0.0;
-  for (size_t i = 0; i < static_cast<size_t>(contingencyTable.rows()); ++i) {
-    const size_t rowSum = contingencyTable.row(i).sum();
-    entropy += (double)rowSum / contingencyTable.sum() *
-      log((double)rowSum / contingencyTable.sum());
+  const double denominator = beta * metrics.mHomogeneity +
+    metrics.mCompleteness;
+  metrics.mVMeasure = denominator ? (1.0 + beta) * metrics.mHomogeneity *
+    metrics.mCompleteness / denominator : 0.0;
+  const double totalPairs = total * (total - 1.0) / 2.0;
+  const double expectedPairs = totalPairs ?
+    classPairs * labelPairs / totalPairs : 0.0;
+  const double maxPairs = (classPairs + labelPairs) / 2.0;
+  metrics.mAdjustedRandIndex = (maxPairs == expectedPairs) ? 1.0 :
+    (sumPairs - expectedPairs) / (maxPairs - expectedPairs);
+  metrics.mClassIoU.assign(numClasses, 0.0);
+  for (size_t i = 0; i < numClasses; ++i)
+    if (classSums[i]) {
+      const double overlap = contingencyTable(i, majorityLabels[i]);
+      metrics.mClassIoU[i] = overlap /
+        (classSums[i] + labelSums[majorityLabels[i]] - overlap);
+    }
+}
+
+bool Evaluator::contains(const Polygon& polygon, const
+    Eigen::Matrix<double, 2, 1>& point) {
+  const size_t numVertices = polygon.rows();
+  if (numVertices < 3)
+    return false;
+  bool inside = false;
+  for (size_t i = 0, j = numVertices - 1; i < numVertices; j = i++)
+    if ((polygon(i, 1) > point(1)) != (polygon(j, 1) > point(1)) &&
+        point(0) < polygon(i, 0) + (point(1) - polygon(i, 1)) *
+        (polygon(j, 0) - polygon(i, 0)) / (polygon(j, 1) - polygon(i, 1)))
+      inside = !inside;
+  return inside;
+}
+
+const Evaluator::LabelMap& Evaluator::rasterize(const Grid<double, Cell, 2>&
+    dem) const {
+  const Grid<double, Cell, 2>::Index& numCells = dem.getNumCells();
+  if (!dem.getNumCellsTot()) {
+    mLabelMap.clear();
+    mLabelMapNumCells = numCells;
+    return mLabelMap;
   }
-  entropy *= -1.0;
-  double homogeneity = 1.0 - (condEntropy / entropy);
-  if (contingencyTable.rows() == 1)
-    homogeneity = 1.0;
-  condEntropy = 0.0;
-  for (size_t i = 0; i < static_cast<size_t>(contingencyTable.rows()); ++i) {
-    const size_t rowSum = contingencyTable.row(i).sum();
-    for (size_t j = 0; j < static_cast<size_t>(contingencyTable.cols()); ++j)
-      if (contingencyTable(i, j))
-        condEntropy += (double)contingencyTable(i, j) / contingencyTable.sum() *
-          log((double)contingencyTable(i, j) / rowSum);
+  // cell centers are an affine function of the index, also for transformed
+  // grids, so polygons are rasterized in index space
+  Grid<double, Cell, 2>::Index idx =
+    (Eigen::Matrix<size_t, 2, 1>() << 0, 0).finished();
+  const Eigen::Matrix<double, 2, 1> origin = dem.getCoordinates(idx);
+  Eigen::Matrix<double, 2, 2> axes = Eigen::Matrix<double, 2, 2>::Zero();
+  for (size_t d = 0; d < 2; ++d)
+    if (numCells(d) > 1) {
+      Grid<double, Cell, 2>::Index step = idx;
+      step(d) = 1;
+      axes.col(d) = dem.getCoordinates(step) - origin;
+    }
+  if (mLabelMap.size() == dem.getNumCellsTot() &&
+      mLabelMapNumCells == numCells && mLabelMapOrigin == origin &&
+      mLabelMapAxes == axes)
+    return mLabelMap;
+  mLabelMapOrigin = origin;
+  mLabelMapAxes = axes;
+  mLabelMapNumCells = numCells;
+  mLabelMap.assign(dem.getNumCellsTot(), noClass);
+  const double det = axes(0, 0) * axes(1, 1) - axes(0, 1) * axes(1, 0);
+  if (det == 0.0) {
+    for (idx(0) = 0; idx(0) < numCells(0); ++idx(0))
+      for (idx(1) = 0; idx(1) < numCells(1); ++idx(1)) {
+        const Eigen::Matrix<double, 2, 1> point = dem.getCoordinates(idx);
+        for (size_t k = 0; k < mClasses.size(); ++k)
+          if (contains(mClasses[k], point)) {
+            mLabelMap[dem.computeLinearIndex(idx)] = k;
+            break;
+          }
+      }
+    return mLabelMap;
+  }
+  std::vector<double> crossings;
+  for (size_t k = 0; k < mClasses.size(); ++k) {
+    const size_t numVertices = mClasses[k].rows();
+    if (numVertices < 3)
+      continue;
+    Polygon polygon(numVertices, 2);
+    for (size_t m = 0; m < numVertices; ++m) {
+      const double x = mClasses[k](m, 0) - origin(0);
+      const double y = mClasses[k](m, 1) - origin(1);
+      polygon(m, 0) = (axes(1, 1) * x - axes(0, 1) * y) / det;
+      polygon(m, 1) = (axes(0, 0) * y - axes(1, 0) * x) / det;
+    }
+    const double uMin = std::max(ceil(polygon.col(0).minCoeff()), 0.0);
+    const double uMax = std::min(floor(polygon.col(0).maxCoeff()),
+      numCells(0) - 1.0);
+    for (double u = uMin; u <= uMax; ++u) {
+      crossings.clear();
+      for (size_t i = 0, j = numVertices - 1; i < numVertices; j = i++)
+        if ((polygon(i, 0) <= u) != (polygon(j, 0) <= u))
+          crossings.push_back(polygon(i, 1) + (u - polygon(i, 0)) *
+            (polygon(j, 1) - polygon(i, 1)) / (polygon(j, 0) - polygon(i, 0)));
+      std::sort(crossings.begin(), crossings.end());
+      idx(0) = u;
+      for (size_t c = 0; c + 1 < crossings.size(); c += 2) {
+        const double vStart = std::max(ceil(crossings[c]), 0.0);
+        const double vEnd = std::min(ceil(crossings[c + 1]),
+          (double)numCells(1));
+        for (double v = vStart; v < vEnd; ++v) {
+          idx(1) = v;
+          size_t& label = mLabelMap[dem.computeLinearIndex(idx)];
+          if (label == noClass)
+            label = k;
+        }
+      }
+    }
+  }
+  return mLabelMap;
+}
+
+Evaluator::LabelMap Evaluator::getLabelMap(const Grid<double, Cell, 2>& dem)
+    const {
+  Mutex::ScopedLock lock(mMutex);
+  return rasterize(dem);
+}
+
+Evaluator::Metrics Evaluator::computeMetrics(const Grid<double, Cell, 2>&
+    dem, const DEMGraph& demgraph, const DEMGraph::VertexContainer&
+    verticesLabels, double beta) const {
+  Mutex::ScopedLock lock(mMutex);
+  const LabelMap& labelMap = rasterize(dem);
+  const size_t numClasses = mClasses.size();
+  std::vector<size_t> counts;
+  for (auto it = verticesLabels.begin(); it != verticesLabels.end(); ++it) {
+    const size_t gtClass = labelMap[dem.computeLinearIndex(it->first)];
+    if (gtClass == noClass)
+      continue;
+    const size_t entry = it->second * numClasses + gtClass;
+    if (entry >= counts.size())
+      counts.resize((it->second + 1) * numClasses, 0);
+    counts[entry]++;
   }
-  condEntropy *= -1.0;
-  entropy = 0.0;
-  for (size_t i = 0; i < static_cast<size_t>(contingencyTable.cols()); ++i) {
-    const size_t columnSum = contingencyTable.col(i).sum();
-    entropy += (double)columnSum / contingencyTable.sum() *
-      log((double)columnSum / contingencyTable.sum());
+  const size_t numLabels = numClasses ? counts.size() / numClasses : 0;
+  Eigen::Matrix<size_t, Eigen::Dynamic, Eigen::Dynamic> contingencyTable(
+    numClasses, numLabels);
+  for (size_t j = 0; j < numLabels; ++j)
+    for (size_t i = 0; i < numClasses; ++i)
+      contingencyTable(i, j) = counts[j * numClasses + i];
+  Metrics metrics;
+  computeClusteringMetrics(contingencyTable, beta, metrics);
+  size_t numLabelBoundaries = 0;
+  size_t numClassBoundaries = 0;
+  size_t numMatchedBoundaries = 0;
+  for (auto it = demgraph.getEdgeBegin(); it != demgraph.getEdgeEnd(); ++it) {
+    const size_t headClass =
+      labelMap[dem.computeLinearIndex(it->getHead())];
+    const size_t tailClass =
+      labelMap[dem.computeLinearIndex(it->getTail())];
+    if (headClass == noClass || tailClass == noClass)
+      continue;
+    auto headLabel = verticesLabels.find(it->getHead());
+    auto tailLabel = verticesLabels.find(it->getTail());
+    if (headLabel == verticesLabels.end() ||
+        tailLabel == verticesLabels.end())
+      continue;
+    const bool labelBoundary = headLabel->second != tailLabel->second;
+    const bool classBoundary = headClass != tailClass;
+    numLabelBoundaries += labelBoundary;
+    numClassBoundaries += classBoundary;
+    numMatchedBoundaries += labelBoundary && classBoundary;
   }
-  entropy *= -1.0;
-  double completeness = 1.0 - (condEntropy / entropy);
-  if (contingencyTable.cols() == 1)
-    completeness = 1.0;
-  return (1.0 + beta) * homogeneity * completeness /
-    (beta * homogeneity + completeness);
+  metrics.mBoundaryPrecision = numLabelBoundaries ?
+    (double)numMatchedBoundaries / numLabelBoundaries : 1.0;
+  metrics.mBoundaryRecall = numClassBoundaries ?
+    (double)numMatchedBoundaries / numClassBoundaries : 1.0;
+  return metrics;
 }
 
 double Evaluator::evaluate(const Grid<double, Cell, 2>& dem, const DEMGraph&
     demgraph, const DEMGraph::VertexContainer& verticesLabels) const {
-  std::set<size_t> labelSet;
-  std::map<size_t, size_t> labelMap;
-  size_t labelPool = 0;
-  for (auto it = verticesLabels.begin(); it != verticesLabels.end(); ++it)
-    if (labelSet.count(it->second) == 0) {
-      labelMap[it->second] = labelPool;
-      labelPool++;
-      labelSet.insert(it->second);
-    }
-  DEMGraph::VertexContainer verticesLabelsMap;
-  for (auto it = demgraph.getVertexBegin(); it != demgraph.getVertexEnd(); ++it)
-    verticesLabelsMap[it->first] =
-      labelMap[verticesLabels.find(it->first)->second];
-  const Grid<double, Cell, 2>::Index& numCells = dem.getNumCells();
-  std::set<size_t> classSet;
-  std::map<size_t, size_t> classMap;
-  size_t classPool = 0;
-  for (size_t i = 0; i < numCells(0); ++i)
-    for (size_t j = 0; j < numCells(1); ++j) {
-      const Cell& cell =
-        dem[(Eigen::Matrix<size_t, 2, 1>() << i, j).finished()];
-      if (!cell.getHeightEstimator().getDist().getKappa())
-        continue;
-      const Eigen::Matrix<double, 2, 1> point = 
-        dem.getCoordinates((Eigen::Matrix<size_t, 2, 1>() << i, j).finished());
-      for (auto it = mClasses.begin(); it != mClasses.end(); ++it)
-        if ((*it)->contains(QPoint(point(0) * 1000.0, point(1) * 1000.0)))
-          if (classSet.count(it - mClasses.begin()) == 0) {
-            classMap[it - mClasses.begin()] = classPool;
-            classPool++;
-            classSet.insert(it - mClasses.begin());
-          }
-    }
-  Eigen::Matrix<size_t, Eigen::Dynamic, Eigen::Dynamic> contingencyTable =
-    Eigen::Matrix<size_t, Eigen::Dynamic, Eigen::Dynamic>::Zero(classSet.size(),
-    labelSet.size());
-  for (auto it = verticesLabelsMap.begin(); it != verticesLabelsMap.end();
-      ++it) {
-    const Eigen::Matrix<double, 2, 1> point = dem.getCoordinates(it->first);
-    const size_t label = it->second;
-    for (auto it = mClasses.begin(); it != mClasses.end(); ++it)
-      if ((*it)->contains(QPoint(point(0) * 1000.0, point(1) * 1000.0)))
-        contingencyTable(classMap[it - mClasses.begin()], label)++;
-  }
-  return computeVMeasure(contingencyTable, 1.0);
+  return computeMetrics(dem, demgraph, verticesLabels).mVMeasure;
 }
 
 size_t Evaluator::getNumClasses() const {
@@ -192,14 +343,15 @@ size_t Evaluator::getNumClasses() const {
 }
 
 void Evaluator::clear() {
-  for (auto it = mClasses.begin(); it != mClasses.end(); ++it)
-    delete *it;
+  Mutex::ScopedLock lock(mMutex);
   mClasses.clear();
+  mLabelMap.clear();
+  mLabelMapNumCells.setZero();
 }
 
 size_t Evaluator::getLabel(const Eigen::Matrix<double, 2, 1>& point) const {
   for (auto it = mClasses.begin(); it != mClasses.end(); ++it)
-    if ((*it)->contains(QPoint(point(0) * 1000.0, point(1) * 1000.0)))
+    if (contains(*it, point))
       return it - mClasses.begin();
   return 0;
 }
@@ -29,9 +29,8 @@
 
 #include <Eigen/Core>
 
-#include <QRegion>
-
 #include "base/Serializable.h"
+#include "base/Mutex.h"
 #include "exceptions/IOException.h"
 #include "utils/IndexHash.h"
 
@@ -46,6 +45,41 @@ class DEMGraph;
 class Evaluator :
   public virtual Serializable {
 public:
+  /** \name Types definitions
+    @{
+    */
+  /// Polygon of a ground truth class, one vertex per row in meters
+  typedef Eigen::Matrix<double, Eigen::Dynamic, 2> Polygon;
+  /// Ground truth class of each cell, in linear index order of the grid
+  typedef std::vector<size_t> LabelMap;
+  /// Metrics of a labeling against the ground truth
+  struct Metrics {
+    /// V-measure
+    double mVMeasure;
+    /// Homogeneity
+    double mHomogeneity;
+    /// Completeness
+    double mCompleteness;
+    /// Adjusted Rand index
+    double mAdjustedRandIndex;
+    /// Intersection over union of each class with its majority label
+    std::vector<double> mClassIoU;
+    /// Fraction of label boundaries lying on ground truth boundaries
+    double mBoundaryPrecision;
+    /// Fraction of ground truth boundaries recovered by label boundaries
+    double mBoundaryRecall;
+  };
+  /** @}
+    */
+
+  /** \name Constants
+    @{
+    */
+  /// Class of cells that are not covered by any polygon
+  static const size_t noClass = (size_t)-1;
+  /** @}
+    */
+
   /** \name Constructors/destructor
     @{
     */
@@ -77,8 +111,14 @@ public:
   double evaluate(const Grid<double, Cell, 2>& dem, const DEMGraph& demgraph,
     const std::unordered_map<Eigen::Matrix<size_t, 2, 1>, size_t, IndexHash>&
     verticesLabels) const;
+  /// Computes all metrics of the labeling against the ground truth at once
+  Metrics computeMetrics(const Grid<double, Cell, 2>& dem, const DEMGraph&
+    demgraph, const std::unordered_map<Eigen::Matrix<size_t, 2, 1>, size_t,
+    IndexHash>& verticesLabels, double beta = 1.0) const;
   /// Returns the label of a point in the ground truth
   size_t getLabel(const Eigen::Matrix<double, 2, 1>& point) const;
+  /// Returns the ground truth class of each cell of a grid
+  LabelMap getLabelMap(const Grid<double, Cell, 2>& dem) const;
   /** @}
     */
 
@@ -100,10 +140,15 @@ protected:
   /** \name Protected methods
     @{
     */
-  /// Compute the V-Measure
-  double computeVMeasure(const
+  /// Computes the clustering metrics from a contingency table
+  void computeClusteringMetrics(const
     Eigen::Matrix<size_t, Eigen::Dynamic, Eigen::Dynamic>& contingencyTable,
-    double beta) const;
+    double beta, Metrics& metrics) const;
+  /// Returns the cached label map, rasterizing it if the grid changed
+  const LabelMap& rasterize(const Grid<double, Cell, 2>& dem) const;
+  /// Check if a polygon contains a point
+  static bool contains(const Polygon& polygon, const
+    Eigen::Matrix<double, 2, 1>& point);
   /** @}
     */
 
@@ -111,7 +156,17 @@ protected:
       @{
     */
   /// Ground truth classes
-  std::vector<const QRegion*> mClasses;
+  std::vector<Polygon> mClasses;
+  /// Cached label map
+  mutable LabelMap mLabelMap;
+  /// Grid origin the label map was rasterized for
+  mutable Eigen::Matrix<double, 2, 1> mLabelMapOrigin;
+  /// Grid axes the label map was rasterized for
+  mutable Eigen::Matrix<double, 2, 2> mLabelMapAxes;
+  /// Number of cells the label map was rasterized for
+  mutable Eigen::Matrix<size_t, 2, 1> mLabelMapNumCells;
+  /// Mutex protecting the label map cache
+  mutable Mutex mMutex;
   /** @}
     */
 
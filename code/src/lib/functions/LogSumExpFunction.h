@@ -65,6 +65,9 @@ public:
     */
   /// Access the function value for the given argument
   virtual double getValue(const VariableType& argument) const;
+  /// Access the function values for each row of the given arguments
+  void getRowValues(const Eigen::Matrix<X, Eigen::Dynamic, M>& arguments,
+    Eigen::Matrix<double, Eigen::Dynamic, 1>& values) const;
   /** @}
     */
 
@@ -39,3 +39,15 @@ double LogSumExpFunction<X, M>::getValue(const VariableType& argument) const {
   X max = argument.maxCoeff();
   return log((argument.cwise() - max).cwise().exp().sum()) + max;
 }
+
+template <typename X, size_t M>
+void LogSumExpFunction<X, M>::getRowValues(const
+    Eigen::Matrix<X, Eigen::Dynamic, M>& arguments,
+    Eigen::Matrix<double, Eigen::Dynamic, 1>& values) const {
+  values = arguments.rowwise().maxCoeff().template cast<double>();
+  Eigen::Matrix<double, Eigen::Dynamic, 1> sums =
+    Eigen::Matrix<double, Eigen::Dynamic, 1>::Zero(arguments.rows());
+  for (size_t j = 0; j < (size_t)arguments.cols(); ++j)
+    sums += (arguments.col(j).template cast<double>() - values).cwise().exp();
+  values += sums.cwise().log();
+}
@@ -23,12 +23,102 @@
 #ifndef FGTOOLS_H
 #define FGTOOLS_H
 
+#include <vector>
+
 #include "data-structures/Grid.h"
 #include "data-structures/Cell.h"
 #include "data-structures/DEMGraph.h"
 #include "data-structures/FactorGraph.h"
+#include "statistics/MixtureDistribution.h"
+#include "statistics/LinearRegression.h"
+#include "ml/PottsGrid.h"
+#include "base/ThreadPool.h"
 
 namespace Helpers {
+  /** The NodePotentialsTask class computes the node potentials of the DEM
+      graph vertices for all the mixture components. The coordinates and the
+      height modes of the vertices are cached once in a structure-of-arrays
+      matrix, in the order of the factor graph variables of buildFactorGraph,
+      and each update writes the potentials in place into a contiguous
+      vertices x components buffer, one block of vertices per task.
+      \brief Node potentials computation task
+    */
+  class NodePotentialsTask :
+    public ThreadPool::Task {
+  public:
+    /** \name Types definitions
+      @{
+      */
+    /// Potentials type, one row per vertex and one column per component
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> Potentials;
+    /** @}
+      */
+
+    /** \name Constructors/destructor
+      @{
+      */
+    /// Constructs task from the DEM and the graph
+    inline NodePotentialsTask(const Grid<double, Cell, 2>& dem,
+      const DEMGraph& graph, size_t numThreads = 1);
+    /// Copy constructor
+    inline NodePotentialsTask(const NodePotentialsTask& other);
+    /// Assignment operator
+    inline NodePotentialsTask& operator = (const NodePotentialsTask& other);
+    /// Destructor
+    inline virtual ~NodePotentialsTask();
+    /** @}
+      */
+
+    /** \name Accessors
+      @{
+      */
+    /// Returns the number of vertices
+    inline size_t getNumVertices() const;
+    /// Returns a vertex
+    inline const DEMGraph::VertexDescriptor& getVertex(size_t vertex) const;
+    /// Returns the potentials of the last update
+    inline const Potentials& getPotentials() const;
+    /// Returns the number of threads
+    inline size_t getNumThreads() const;
+    /// Sets the number of threads (0 means one per CPU)
+    inline void setNumThreads(size_t numThreads);
+    /** @}
+      */
+
+    /** \name Methods
+      @{
+      */
+    /// Computes the potentials of all vertices for a mixture
+    inline void update(const MixtureDistribution<LinearRegression<3>,
+      Eigen::Dynamic>& mixture);
+    /// Computes the potentials of a block of vertices
+    inline virtual void process(size_t block);
+    /** @}
+      */
+
+  protected:
+    /** \name Protected members
+      @{
+      */
+    /// Vertices in the order of the factor graph variables
+    std::vector<DEMGraph::VertexDescriptor> mVertices;
+    /// Coordinates and height modes of the vertices, one per row
+    Eigen::Matrix<double, Eigen::Dynamic, 3> mPoints;
+    /// Potentials of the vertices
+    Potentials mPotentials;
+    /// Mixture of the current update
+    const MixtureDistribution<LinearRegression<3>, Eigen::Dynamic>* mMixture;
+    /// Number of vertices per block
+    size_t mBlockSize;
+    /// Number of threads
+    size_t mNumThreads;
+    /// Thread pool, kept across updates and rebuilt when mNumThreads changes
+    ThreadPool* mThreadPool;
+    /** @}
+      */
+
+  };
+
   /** \name Methods
     @{
     */
@@ -46,6 +136,23 @@ namespace Helpers {
   inline void computeNodeFactor(const Grid<double, Cell, 2>& dem, const
     MixtureDistribution<LinearRegression<3>, Eigen::Dynamic>& mixture, const
     Grid<double, Cell, 2>::Index& index, dai::Factor& factor);
+  /// The buildPottsGrid function sets up a Potts grid from a DEMGraph.
+  inline void buildPottsGrid(const Grid<double, Cell, 2>& dem, const DEMGraph&
+    graph, const MixtureDistribution<LinearRegression<3>, Eigen::Dynamic>&
+    mixture, PottsGrid& pottsGrid, double strength = 10.0);
+  /// The updateNodePotentials function updates Potts grid node potentials.
+  inline void updateNodePotentials(const Grid<double, Cell, 2>& dem,
+    const DEMGraph& graph,
+    const MixtureDistribution<LinearRegression<3>, Eigen::Dynamic>& mixture,
+    PottsGrid& pottsGrid);
+  /// The updateNodeFactors function copies computed node potentials into the
+  /// factor graph through preallocated factors.
+  inline void updateNodeFactors(const NodePotentialsTask& nodePotentials,
+    FactorGraph& factorGraph, std::vector<dai::Factor>& factors);
+  /// The updateNodePotentials function copies computed node potentials into
+  /// a Potts grid.
+  inline void updateNodePotentials(const NodePotentialsTask& nodePotentials,
+    PottsGrid& pottsGrid);
   /** @}
     */
 
@@ -17,16 +17,134 @@
  ******************************************************************************/
 
 #include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include <Eigen/Array>
 
 #include "statistics/NormalDistribution.h"
 #include "utils/IndexHash.h"
 
 namespace Helpers {
 
+/******************************************************************************/
+/* Constructors and Destructor                                                */
+/******************************************************************************/
+
+NodePotentialsTask::NodePotentialsTask(const Grid<double, Cell, 2>& dem,
+    const DEMGraph& graph, size_t numThreads) :
+    mPoints(graph.getNumVertices(), 3),
+    mMixture(0),
+    mBlockSize(graph.getNumVertices()),
+    mNumThreads(1),
+    mThreadPool(0) {
+  mVertices.reserve(graph.getNumVertices());
+  for (auto it = graph.getVertexBegin(); it != graph.getVertexEnd(); ++it) {
+    const size_t row = mVertices.size();
+    mVertices.push_back(it->first);
+    auto mode = dem[it->first].getHeightEstimator().getDist().getMode();
+    mPoints.block(row, 0, 1, 2) = dem.getCoordinates(it->first).transpose();
+    mPoints(row, 2) = std::get<0>(mode);
+  }
+  setNumThreads(numThreads);
+}
+
+NodePotentialsTask::NodePotentialsTask(const NodePotentialsTask& other) :
+    mVertices(other.mVertices),
+    mPoints(other.mPoints),
+    mPotentials(other.mPotentials),
+    mMixture(0),
+    mBlockSize(other.mBlockSize),
+    mNumThreads(other.mNumThreads),
+    mThreadPool(0) {
+}
+
+NodePotentialsTask& NodePotentialsTask::operator = (const NodePotentialsTask&
+    other) {
+  if (this != &other) {
+    mVertices = other.mVertices;
+    mPoints = other.mPoints;
+    mPotentials = other.mPotentials;
+    mMixture = 0;
+    setNumThreads(other.mNumThreads);
+  }
+  return *this;
+}
+
+NodePotentialsTask::~NodePotentialsTask() {
+  delete mThreadPool;
+}
+
+/******************************************************************************/
+/* Accessors                                                                  */
+/******************************************************************************/
+
+size_t NodePotentialsTask::getNumVertices() const {
+  return mVertices.size();
+}
+
+const DEMGraph::VertexDescriptor& NodePotentialsTask::getVertex(size_t
+    vertex) const {
+  return mVertices[vertex];
+}
+
+const NodePotentialsTask::Potentials& NodePotentialsTask::getPotentials()
+    const {
+  return mPotentials;
+}
+
+size_t NodePotentialsTask::getNumThreads() const {
+  return mNumThreads;
+}
+
+void NodePotentialsTask::setNumThreads(size_t numThreads) {
+  numThreads = numThreads ? numThreads : ThreadPool::getNumCPUs();
+  if (numThreads != mNumThreads) {
+    delete mThreadPool;
+    mThreadPool = 0;
+  }
+  mNumThreads = numThreads;
+  mBlockSize = std::max((mVertices.size() + mNumThreads - 1) / mNumThreads,
+    (size_t)1);
+}
+
 /******************************************************************************/
 /* Methods                                                                    */
 /******************************************************************************/
 
+void NodePotentialsTask::update(const MixtureDistribution<LinearRegression<3>,
+    Eigen::Dynamic>& mixture) {
+  const size_t numLabels = mixture.getCompDistributions().size();
+  if (mPotentials.rows() != (int)mVertices.size() ||
+      mPotentials.cols() != (int)numLabels)
+    mPotentials.resize(mVertices.size(), numLabels);
+  mMixture = &mixture;
+  if (!mThreadPool)
+    mThreadPool = new ThreadPool(mNumThreads);
+  mThreadPool->process(*this, (mVertices.size() + mBlockSize - 1) /
+    mBlockSize);
+  mMixture = 0;
+}
+
+void NodePotentialsTask::process(size_t block) {
+  const size_t start = block * mBlockSize;
+  const size_t size = std::min(mBlockSize, mVertices.size() - start);
+  for (size_t i = 0; i < (size_t)mPotentials.cols(); ++i) {
+    const LinearRegression<3>& plane = mMixture->getCompDistribution(i);
+    const Eigen::Matrix<double, 3, 1>& coefficients =
+      plane.getLinearBasisFunction().getCoefficients();
+    const double variance = plane.getVariance();
+    mPotentials.block(start, i, size, 1) = ((mPoints.block(start, 2, size, 1) -
+      mPoints.block(start, 0, size, 1) * coefficients(1) -
+      mPoints.block(start, 1, size, 1) * coefficients(2)).cwise() -
+      coefficients(0)).cwise().square() * (-0.5 / variance);
+    mPotentials.block(start, i, size, 1) =
+      mPotentials.block(start, i, size, 1).cwise().exp() *
+      (mMixture->getAssignDistribution().getProbability(i) /
+      sqrt(2.0 * M_PI * variance));
+  }
+}
+
 void buildFactorGraph(const Grid<double, Cell, 2>& dem, const DEMGraph&
     graph, const MixtureDistribution<LinearRegression<3>, Eigen::Dynamic>&
     mixture, FactorGraph& factorGraph,
@@ -86,4 +204,62 @@ void computeNodeFactor(const Grid<double, Cell, 2>& dem, const
       (Eigen::Matrix<double, 3, 1>() << point, target).finished()));
 }
 
+void buildPottsGrid(const Grid<double, Cell, 2>& dem, const DEMGraph& graph,
+    const MixtureDistribution<LinearRegression<3>, Eigen::Dynamic>& mixture,
+    PottsGrid& pottsGrid, double strength) {
+  const Grid<double, Cell, 2>::Index& numCells = dem.getNumCells();
+  pottsGrid.resize(numCells(0), numCells(1),
+    mixture.getCompDistributions().size());
+  pottsGrid.setStrength(strength);
+  for (auto it = graph.getVertexBegin(); it != graph.getVertexEnd(); ++it)
+    pottsGrid.setVertex(it->first(0), it->first(1));
+  updateNodePotentials(dem, graph, mixture, pottsGrid);
+}
+
+void updateNodePotentials(const Grid<double, Cell, 2>& dem,
+    const DEMGraph& graph,
+    const MixtureDistribution<LinearRegression<3>, Eigen::Dynamic>& mixture,
+    PottsGrid& pottsGrid) {
+  PottsGrid::Potentials& potentials = pottsGrid.getNodePotentials();
+  const size_t numLabels = mixture.getCompDistributions().size();
+  for (auto it = graph.getVertexBegin(); it != graph.getVertexEnd(); ++it) {
+    const Grid<double, Cell, 2>::Index& index = it->first;
+    const size_t cell = pottsGrid.getCell(index(0), index(1));
+    const Eigen::Matrix<double, 2, 1> point = dem.getCoordinates(index);
+    auto mode = dem[index].getHeightEstimator().getDist().getMode();
+    const double target = std::get<0>(mode);
+    for (size_t i = 0; i < numLabels; ++i)
+      potentials(i, cell) = mixture.getAssignDistribution().getProbability(i) *
+        mixture.getCompDistribution(i).pdf(
+        (Eigen::Matrix<double, 3, 1>() << point, target).finished());
+  }
+}
+
+void updateNodeFactors(const NodePotentialsTask& nodePotentials,
+    FactorGraph& factorGraph, std::vector<dai::Factor>& factors) {
+  const NodePotentialsTask::Potentials& potentials =
+    nodePotentials.getPotentials();
+  if (factors.size() != nodePotentials.getNumVertices()) {
+    factors.clear();
+    factors.reserve(nodePotentials.getNumVertices());
+    for (size_t i = 0; i < nodePotentials.getNumVertices(); ++i)
+      factors.push_back(dai::Factor(factorGraph.var(i)));
+  }
+  for (size_t i = 0; i < factors.size(); ++i) {
+    for (size_t j = 0; j < (size_t)potentials.cols(); ++j)
+      factors[i].set(j, potentials(i, j));
+    factorGraph.setFactor(i, factors[i]);
+  }
+}
+
+void updateNodePotentials(const NodePotentialsTask& nodePotentials,
+    PottsGrid& pottsGrid) {
+  PottsGrid::Potentials& potentials = pottsGrid.getNodePotentials();
+  for (size_t i = 0; i < nodePotentials.getNumVertices(); ++i) {
+    const DEMGraph::VertexDescriptor& index = nodePotentials.getVertex(i);
+    potentials.col(pottsGrid.getCell(index(0), index(1))) =
+      nodePotentials.getPotentials().row(i).transpose();
+  }
+}
+
 }
@@ -32,20 +32,93 @@
 #include "statistics/EstimatorML.h"
 #include "statistics/LinearRegression.h"
 #include "statistics/MixtureDistribution.h"
+#include "base/ThreadPool.h"
+#include "base/ArenaAllocator.h"
 
 namespace Helpers {
+  /** The InitMLTask class fits the plane of each component for initML. The
+      points of all components are written once into the output container,
+      each component filling its own range, and the plane is fitted from
+      moments accumulated while the points are written.
+      \brief Plane fitting task of initML
+    */
+  class InitMLTask :
+    public ThreadPool::Task {
+  public:
+    /** \name Types definitions
+      @{
+      */
+    /// Component type
+    typedef GraphSegmenter<DEMGraph>::ComponentType ComponentType;
+    /// Components pointers type
+    typedef std::vector<const ComponentType*,
+      ArenaAllocator<const ComponentType*> > ComponentPointers;
+    /// Offsets type
+    typedef std::vector<size_t, ArenaAllocator<size_t> > Offsets;
+    /// Planes type
+    typedef std::vector<LinearRegression<3>,
+      ArenaAllocator<LinearRegression<3> > > Planes;
+    /** @}
+      */
+
+    /** \name Constructors/destructor
+      @{
+      */
+    /// Constructs task from the DEM, the components, and the outputs
+    inline InitMLTask(const Grid<double, Cell, 2>& dem,
+      const ComponentPointers& components, const Offsets& offsets,
+      EstimatorML<LinearRegression<3> >::Container& points,
+      std::vector<DEMGraph::VertexDescriptor>& pointsMapping, Planes& planes,
+      Eigen::Matrix<double, Eigen::Dynamic, 1>& numPoints, bool weighted);
+    /** @}
+      */
+
+    /** \name Methods
+      @{
+      */
+    /// Fits the plane of a component
+    inline virtual void process(size_t component);
+    /** @}
+      */
+
+  protected:
+    /** \name Protected members
+      @{
+      */
+    /// DEM
+    const Grid<double, Cell, 2>& mDEM;
+    /// Components
+    const ComponentPointers& mComponents;
+    /// First row of each component
+    const Offsets& mOffsets;
+    /// Points
+    EstimatorML<LinearRegression<3> >::Container& mPoints;
+    /// Points mapping to the DEM
+    std::vector<DEMGraph::VertexDescriptor>& mPointsMapping;
+    /// Fitted planes
+    Planes& mPlanes;
+    /// Number of points of each valid plane, 0 for invalid ones
+    Eigen::Matrix<double, Eigen::Dynamic, 1>& mNumPoints;
+    /// Weighted regression flag
+    bool mWeighted;
+    /** @}
+      */
+
+  };
+
   /** \name Methods
     @{
     */
   /** The initML function generates initial values for the Maximum-Likelihood
-      estimation of a mixtures of linear regression models.
+      estimation of a mixtures of linear regression models. Its temporaries
+      are drawn from the arena of the components allocator, if any.
   */
   inline bool initML(const Grid<double, Cell, 2>& dem, const DEMGraph& graph,
     const GraphSegmenter<DEMGraph>::Components& components,
     EstimatorML<LinearRegression<3> >::Container& points,
     std::vector<DEMGraph::VertexDescriptor>& pointsMapping,
     MixtureDistribution<LinearRegression<3>, Eigen::Dynamic>*& initMixture,
-    bool weighted = true);
+    bool weighted = true, size_t numThreads = 1);
   /** @}
     */
 
@@ -16,62 +16,97 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
  ******************************************************************************/
 
-#include "data-structures/PointCloud.h"
-
 namespace Helpers {
 
+/******************************************************************************/
+/* Constructors and Destructor                                                */
+/******************************************************************************/
+
+InitMLTask::InitMLTask(const Grid<double, Cell, 2>& dem,
+    const ComponentPointers& components, const Offsets& offsets,
+    EstimatorML<LinearRegression<3> >::Container& points,
+    std::vector<DEMGraph::VertexDescriptor>& pointsMapping, Planes& planes,
+    Eigen::Matrix<double, Eigen::Dynamic, 1>& numPoints, bool weighted) :
+    mDEM(dem),
+    mComponents(components),
+    mOffsets(offsets),
+    mPoints(points),
+    mPointsMapping(pointsMapping),
+    mPlanes(planes),
+    mNumPoints(numPoints),
+    mWeighted(weighted) {
+}
+
 /******************************************************************************/
 /* Methods                                                                    */
 /******************************************************************************/
 
+void InitMLTask::process(size_t component) {
+  const ComponentType& comp = *mComponents[component];
+  const size_t offset = mOffsets[component];
+  const size_t numPoints = comp.getNumVertices();
+  EstimatorML<LinearRegression<3> >::Moments moments =
+    EstimatorML<LinearRegression<3> >::Moments::Zero();
+  for (auto itV = comp.getVertexBegin(); itV != comp.getVertexEnd(); ++itV) {
+    const size_t row = offset + (itV - comp.getVertexBegin());
+    auto mode = mDEM[*itV].getHeightEstimator().getDist().getMode();
+    Eigen::Matrix<double, 3, 1>& point = mPoints[row];
+    point.segment(0, 2) = mDEM.getCoordinates(*itV);
+    point(2) = std::get<0>(mode);
+    EstimatorML<LinearRegression<3> >::addMoments(moments, point,
+      mWeighted ? 1.0 / std::get<1>(mode) : 1.0);
+    mPointsMapping[row] = *itV;
+  }
+  EstimatorML<LinearRegression<3> > estPlane;
+  estPlane.addPoints(moments, numPoints);
+  if (estPlane.getValid()) {
+    mPlanes[component] = estPlane.getDistribution();
+    mNumPoints(component) = numPoints;
+  }
+  else
+    mNumPoints(component) = 0;
+}
+
 bool initML(const Grid<double, Cell, 2>& dem, const DEMGraph& graph, const
     GraphSegmenter<DEMGraph>::Components& components,
     EstimatorML<LinearRegression<3> >::Container& points,
     std::vector<DEMGraph::VertexDescriptor>& pointsMapping,
     MixtureDistribution<LinearRegression<3>, Eigen::Dynamic>*& initMixture,
-    bool weighted) {
-  points.clear();
-  pointsMapping.clear();
-  pointsMapping.reserve(graph.getNumVertices());
+    bool weighted, size_t numThreads) {
+  Arena* arena = components.get_allocator().getArena();
+  InitMLTask::ComponentPointers comps(arena);
+  comps.reserve(components.size());
+  InitMLTask::Offsets offsets(arena);
+  offsets.reserve(components.size());
+  size_t numPointsTotal = 0;
+  for (auto it = components.begin(); it != components.end(); ++it) {
+    comps.push_back(&it->second);
+    offsets.push_back(numPointsTotal);
+    numPointsTotal += it->second.getNumVertices();
+  }
   points.reserve(graph.getNumVertices());
+  points.resize(numPointsTotal);
+  pointsMapping.reserve(graph.getNumVertices());
+  pointsMapping.resize(numPointsTotal);
+  InitMLTask::Planes planes(comps.size(), LinearRegression<3>(), arena);
+  Eigen::Matrix<double, Eigen::Dynamic, 1> numPoints(comps.size());
+  InitMLTask task(dem, comps, offsets, points, pointsMapping, planes,
+    numPoints, weighted);
+  ThreadPool pool(numThreads);
+  pool.process(task, comps.size());
+  size_t numValid = 0;
+  for (size_t i = 0; i < comps.size(); ++i)
+    if (numPoints(i) > 0)
+      numValid++;
   std::vector<LinearRegression<3> > distPlanes;
-  distPlanes.reserve(components.size());
-  std::vector<double> numPoints;
-  numPoints.reserve(components.size());
-  EstimatorML<LinearRegression<3> > estPlane;
-  for (auto it = components.begin(); it != components.end(); ++it) {
-    EstimatorML<LinearRegression<3> >::ConstPointIterator itStart =
-      points.end();
-    Eigen::Matrix<double, Eigen::Dynamic, 1>
-      precision(it->second.getNumVertices());
-    for (auto itV = it->second.getVertexBegin();
-        itV != it->second.getVertexEnd(); ++itV) {
-      PointCloud<double, 3>::Point point;
-      point.segment(0, 2) = dem.getCoordinates(*itV);
-      auto mode = dem[*itV].getHeightEstimator().getDist().getMode();
-      point(2) = std::get<0>(mode);
-      points.push_back(point);
-      pointsMapping.push_back(*itV);
-      precision(itV - it->second.getVertexBegin()) =
-        1.0 / std::get<1>(mode);
-    }
-    auto itEnd = points.end();
-    if (weighted)
-      estPlane.addPoints(itStart, itEnd, precision);
-    else
-      estPlane.addPoints(itStart, itEnd);
-    if (estPlane.getValid()) {
-      distPlanes.push_back(estPlane.getDistribution());
-      numPoints.push_back(it->second.getNumVertices());
+  distPlanes.reserve(numValid);
+  Eigen::Matrix<double, Eigen::Dynamic, 1> weights(numValid);
+  for (size_t i = 0; i < comps.size(); ++i)
+    if (numPoints(i) > 0) {
+      weights(distPlanes.size()) = numPoints(i);
+      distPlanes.push_back(planes[i]);
     }
-  }
   if (distPlanes.size() != 0) {
-    double pointsSum = 0;
-    Eigen::Matrix<double, Eigen::Dynamic, 1> weights(numPoints.size());
-    for (auto it = numPoints.begin(); it != numPoints.end(); ++it) {
-      pointsSum += *it;
-      weights(it - numPoints.begin()) = *it;
-    }
     initMixture = new
       MixtureDistribution<LinearRegression<3>, Eigen::Dynamic>(distPlanes,
       CategoricalDistribution<Eigen::Dynamic>(weights / weights.sum()));
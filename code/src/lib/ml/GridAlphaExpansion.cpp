@@ -0,0 +1,155 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include "ml/GridAlphaExpansion.h"
+
+#include <algorithm>
+
+#include "exceptions/OutOfBoundException.h"
+
+/******************************************************************************/
+/* Constructors and Destructor                                                */
+/******************************************************************************/
+
+GridAlphaExpansion::GridAlphaExpansion(size_t numRows, size_t numCols,
+    size_t numLabels, double strength, size_t maxNumIter) :
+    PottsGrid(numRows, numCols, numLabels, strength),
+    mMaxNumIter(maxNumIter),
+    mNumIter(0),
+    mNumMoves(0) {
+}
+
+GridAlphaExpansion::GridAlphaExpansion(const GridAlphaExpansion& other) :
+    PottsGrid(other),
+    mLabels(other.mLabels),
+    mMaxNumIter(other.mMaxNumIter),
+    mNumIter(other.mNumIter),
+    mNumMoves(other.mNumMoves) {
+}
+
+GridAlphaExpansion& GridAlphaExpansion::operator =
+    (const GridAlphaExpansion& other) {
+  if (this != &other) {
+    PottsGrid::operator=(other);
+    mLabels = other.mLabels;
+    mMaxNumIter = other.mMaxNumIter;
+    mNumIter = other.mNumIter;
+    mNumMoves = other.mNumMoves;
+  }
+  return *this;
+}
+
+GridAlphaExpansion::~GridAlphaExpansion() {
+}
+
+/******************************************************************************/
+/* Accessors                                                                  */
+/******************************************************************************/
+
+size_t GridAlphaExpansion::getMaxNumIter() const {
+  return mMaxNumIter;
+}
+
+void GridAlphaExpansion::setMaxNumIter(size_t maxNumIter) {
+  mMaxNumIter = maxNumIter;
+}
+
+size_t GridAlphaExpansion::getNumIterations() const {
+  return mNumIter;
+}
+
+size_t GridAlphaExpansion::getNumMoves() const {
+  return mNumMoves;
+}
+
+size_t GridAlphaExpansion::getLabel(size_t cell) const {
+  if (cell >= getNumCells())
+    throw OutOfBoundException<size_t>(cell,
+      "GridAlphaExpansion::getLabel(): cell out of range",
+      __FILE__, __LINE__);
+  return cell < mLabels.size() ? mLabels[cell] : 0;
+}
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+size_t GridAlphaExpansion::run() {
+  const size_t numCells = getNumCells();
+  mLabels.assign(numCells, 0);
+  for (size_t cell = 0; cell < numCells; ++cell)
+    if (mVertices[cell])
+      for (size_t i = 1; i < mNumLabels; ++i)
+        if (mNodePotentials(i, cell) > mNodePotentials(mLabels[cell], cell))
+          mLabels[cell] = i;
+  double energy = computeEnergy(mLabels);
+  mNumMoves = 0;
+  for (mNumIter = 0; mNumIter < mMaxNumIter; ) {
+    const size_t numMoves = mNumMoves;
+    for (size_t alpha = 0; alpha < mNumLabels; ++alpha)
+      energy = expand(alpha, energy);
+    ++mNumIter;
+    if (mNumMoves == numMoves)
+      break;
+  }
+  return mNumIter;
+}
+
+double GridAlphaExpansion::expand(size_t alpha, double energy) {
+  const size_t numCells = getNumCells();
+  std::vector<double> costsAlpha(numCells, 0.0);
+  std::vector<double> costsKeep(numCells, 0.0);
+  mGraph.reset(numCells);
+  for (size_t cell = 0; cell < numCells; ++cell) {
+    if (!mVertices[cell])
+      continue;
+    costsAlpha[cell] += getCost(alpha, cell);
+    costsKeep[cell] += getCost(mLabels[cell], cell);
+    const Direction forward[] = {right, down};
+    for (size_t d = 0; d < 2; ++d) {
+      size_t neighbour;
+      if (!getNeighbour(cell, forward[d], neighbour))
+        continue;
+      const double b = (mLabels[neighbour] != alpha) ? mStrength : 0.0;
+      const double c = (mLabels[cell] != alpha) ? mStrength : 0.0;
+      const double e = (mLabels[cell] != mLabels[neighbour]) ? mStrength :
+        0.0;
+      costsKeep[cell] += c;
+      costsKeep[neighbour] += e - c;
+      mGraph.addEdge(cell, neighbour, b + c - e);
+    }
+  }
+  for (size_t cell = 0; cell < numCells; ++cell)
+    if (mVertices[cell]) {
+      const double minCost = std::min(costsAlpha[cell], costsKeep[cell]);
+      mGraph.addTerminalEdges(cell, costsKeep[cell] - minCost,
+        costsAlpha[cell] - minCost);
+    }
+  mGraph.compute();
+  mCandidateLabels = mLabels;
+  for (size_t cell = 0; cell < numCells; ++cell)
+    if (mVertices[cell] && mGraph.isSourceSide(cell))
+      mCandidateLabels[cell] = alpha;
+  const double candidateEnergy = computeEnergy(mCandidateLabels);
+  if (candidateEnergy < energy) {
+    mLabels.swap(mCandidateLabels);
+    mNumMoves++;
+    return candidateEnergy;
+  }
+  return energy;
+}
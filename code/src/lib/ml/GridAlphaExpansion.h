@@ -0,0 +1,111 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file GridAlphaExpansion.h
+    \brief This file defines the GridAlphaExpansion class, which computes MAP
+           labelings of Potts grids by alpha-expansion moves.
+  */
+
+#ifndef GRIDALPHAEXPANSION_H
+#define GRIDALPHAEXPANSION_H
+
+#include <vector>
+
+#include "ml/PottsGrid.h"
+#include "ml/MaxFlow.h"
+
+/** The class GridAlphaExpansion implements the alpha-expansion algorithm of
+    Boykov, Veksler, and Zabih on 4-connected grids with Potts pairwise
+    factors. Each move lets every cell either keep its label or switch to the
+    label alpha, and the optimal move is found with a minimum s-t cut. Cycles
+    over all labels are repeated until no move decreases the energy, which
+    then lies within a factor of 2 of the optimum for the Potts model.
+    \brief Alpha-expansion MAP labeling of Potts grids
+  */
+class GridAlphaExpansion :
+  public PottsGrid {
+public:
+  /** \name Constructors/destructor
+    @{
+    */
+  /// Constructs alpha-expansion on a grid with all cells disabled
+  GridAlphaExpansion(size_t numRows = 0, size_t numCols = 0,
+    size_t numLabels = 1, double strength = 10.0, size_t maxNumIter = 10);
+  /// Copy constructor
+  GridAlphaExpansion(const GridAlphaExpansion& other);
+  /// Assignment operator
+  GridAlphaExpansion& operator = (const GridAlphaExpansion& other);
+  /// Destructor
+  virtual ~GridAlphaExpansion();
+  /** @}
+    */
+
+  /** \name Accessors
+    @{
+    */
+  /// Returns the maximum number of cycles over the labels
+  size_t getMaxNumIter() const;
+  /// Sets the maximum number of cycles over the labels
+  void setMaxNumIter(size_t maxNumIter);
+  /// Returns the number of cycles of the last run
+  size_t getNumIterations() const;
+  /// Returns the number of successful moves of the last run
+  size_t getNumMoves() const;
+  /// Returns the label of a cell
+  virtual size_t getLabel(size_t cell) const;
+  /** @}
+    */
+
+  /** \name Methods
+    @{
+    */
+  /// Runs alpha-expansion until convergence / Returns the number of cycles
+  virtual size_t run();
+  /** @}
+    */
+
+protected:
+  /** \name Protected methods
+    @{
+    */
+  /// Performs the optimal expansion move of a label / Returns the energy
+  double expand(size_t alpha, double energy);
+  /** @}
+    */
+
+  /** \name Protected members
+    @{
+    */
+  /// Labels of the cells
+  std::vector<size_t> mLabels;
+  /// Candidate labels of the cells
+  std::vector<size_t> mCandidateLabels;
+  /// Graph for the minimum cuts
+  MaxFlow mGraph;
+  /// Maximum number of cycles over the labels
+  size_t mMaxNumIter;
+  /// Number of cycles of the last run
+  size_t mNumIter;
+  /// Number of successful moves of the last run
+  size_t mNumMoves;
+  /** @}
+    */
+
+};
+
+#endif // GRIDALPHAEXPANSION_H
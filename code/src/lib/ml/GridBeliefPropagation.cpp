@@ -0,0 +1,621 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include "ml/GridBeliefPropagation.h"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include <Eigen/Array>
+
+#include "base/Clock.h"
+#include "exceptions/BadArgumentException.h"
+#include "exceptions/OutOfBoundException.h"
+
+/******************************************************************************/
+/* Statics                                                                    */
+/******************************************************************************/
+
+const double GridBeliefPropagation::maxCoarseStrength = 100.0;
+
+/******************************************************************************/
+/* Constructors and Destructor                                                */
+/******************************************************************************/
+
+GridBeliefPropagation::GridBeliefPropagation(size_t numRows, size_t numCols,
+    size_t numLabels, double strength, size_t maxNumIter, double tol,
+    Inference inference, bool logDomain, Schedule schedule,
+    size_t numThreads) :
+    PottsGrid(0, 0, numLabels, strength),
+    mPotts(exp(strength)),
+    mMaxNumIter(maxNumIter),
+    mTol(tol),
+    mInference(inference),
+    mLogDomain(logDomain),
+    mSchedule(schedule),
+    mNumThreads(numThreads),
+    mNumLevels(1),
+    mTimeBudget(0),
+    mWarmStart(false),
+    mNumIter(0),
+    mMaxDiff(0) {
+  resize(numRows, numCols, numLabels);
+}
+
+GridBeliefPropagation::GridBeliefPropagation(const GridBeliefPropagation&
+    other) :
+    PottsGrid(other),
+    mLogPotentials(other.mLogPotentials),
+    mMessages(other.mMessages),
+    mBeliefs(other.mBeliefs),
+    mPotts(other.mPotts),
+    mMaxNumIter(other.mMaxNumIter),
+    mTol(other.mTol),
+    mInference(other.mInference),
+    mLogDomain(other.mLogDomain),
+    mSchedule(other.mSchedule),
+    mNumThreads(other.mNumThreads),
+    mNumLevels(other.mNumLevels),
+    mRowDiffs(other.mRowDiffs),
+    mRowResiduals(other.mRowResiduals),
+    mPendingMessages(other.mPendingMessages),
+    mResiduals(other.mResiduals),
+    mHeap(other.mHeap),
+    mHeapPositions(other.mHeapPositions),
+    mTimeBudget(other.mTimeBudget),
+    mWarmStart(other.mWarmStart),
+    mNumIter(other.mNumIter),
+    mMaxDiff(other.mMaxDiff),
+    mIterationStats(other.mIterationStats) {
+}
+
+GridBeliefPropagation& GridBeliefPropagation::operator =
+    (const GridBeliefPropagation& other) {
+  if (this != &other) {
+    PottsGrid::operator=(other);
+    mLogPotentials = other.mLogPotentials;
+    mMessages = other.mMessages;
+    mBeliefs = other.mBeliefs;
+    mPotts = other.mPotts;
+    mMaxNumIter = other.mMaxNumIter;
+    mTol = other.mTol;
+    mInference = other.mInference;
+    mLogDomain = other.mLogDomain;
+    mSchedule = other.mSchedule;
+    mNumThreads = other.mNumThreads;
+    mNumLevels = other.mNumLevels;
+    mRowDiffs = other.mRowDiffs;
+    mRowResiduals = other.mRowResiduals;
+    mPendingMessages = other.mPendingMessages;
+    mResiduals = other.mResiduals;
+    mHeap = other.mHeap;
+    mHeapPositions = other.mHeapPositions;
+    mTimeBudget = other.mTimeBudget;
+    mWarmStart = other.mWarmStart;
+    mNumIter = other.mNumIter;
+    mMaxDiff = other.mMaxDiff;
+    mIterationStats = other.mIterationStats;
+  }
+  return *this;
+}
+
+GridBeliefPropagation::~GridBeliefPropagation() {
+}
+
+GridBeliefPropagation::RowTask::RowTask(GridBeliefPropagation& bp, Step step) :
+    mBP(bp),
+    mStep(step) {
+}
+
+/******************************************************************************/
+/* Accessors                                                                  */
+/******************************************************************************/
+
+size_t GridBeliefPropagation::getMaxNumIter() const {
+  return mMaxNumIter;
+}
+
+void GridBeliefPropagation::setMaxNumIter(size_t maxNumIter) {
+  mMaxNumIter = maxNumIter;
+}
+
+double GridBeliefPropagation::getTolerance() const {
+  return mTol;
+}
+
+void GridBeliefPropagation::setTolerance(double tol) {
+  mTol = tol;
+}
+
+GridBeliefPropagation::Inference GridBeliefPropagation::getInference() const {
+  return mInference;
+}
+
+void GridBeliefPropagation::setInference(Inference inference) {
+  mInference = inference;
+}
+
+bool GridBeliefPropagation::getLogDomain() const {
+  return mLogDomain;
+}
+
+void GridBeliefPropagation::setLogDomain(bool logDomain) {
+  if (logDomain != mLogDomain) {
+    mLogDomain = logDomain;
+    init();
+  }
+}
+
+GridBeliefPropagation::Schedule GridBeliefPropagation::getSchedule() const {
+  return mSchedule;
+}
+
+void GridBeliefPropagation::setSchedule(Schedule schedule) {
+  mSchedule = schedule;
+}
+
+size_t GridBeliefPropagation::getNumThreads() const {
+  return mNumThreads;
+}
+
+void GridBeliefPropagation::setNumThreads(size_t numThreads) {
+  mNumThreads = numThreads;
+}
+
+size_t GridBeliefPropagation::getNumLevels() const {
+  return mNumLevels;
+}
+
+void GridBeliefPropagation::setNumLevels(size_t numLevels) {
+  if (numLevels == 0)
+    throw BadArgumentException<size_t>(numLevels,
+      "GridBeliefPropagation::setNumLevels(): number of levels must be "
+      "strictly positive", __FILE__, __LINE__);
+  mNumLevels = numLevels;
+}
+
+bool GridBeliefPropagation::getWarmStart() const {
+  return mWarmStart;
+}
+
+double GridBeliefPropagation::getTimeBudget() const {
+  return mTimeBudget;
+}
+
+void GridBeliefPropagation::setTimeBudget(double timeBudget) {
+  mTimeBudget = timeBudget;
+}
+
+size_t GridBeliefPropagation::getNumIterations() const {
+  return mNumIter;
+}
+
+const std::vector<GridBeliefPropagation::IterationStats>&
+    GridBeliefPropagation::getIterationStats() const {
+  return mIterationStats;
+}
+
+double GridBeliefPropagation::getMaxDiff() const {
+  return mMaxDiff;
+}
+
+const GridBeliefPropagation::Potentials& GridBeliefPropagation::getBeliefs()
+    const {
+  return mBeliefs;
+}
+
+size_t GridBeliefPropagation::getLabel(size_t cell) const {
+  if (cell >= getNumCells())
+    throw OutOfBoundException<size_t>(cell,
+      "GridBeliefPropagation::getLabel(): cell out of range",
+      __FILE__, __LINE__);
+  size_t label = 0;
+  for (size_t i = 1; i < mNumLabels; ++i)
+    if (mBeliefs(i, cell) > mBeliefs(label, cell))
+      label = i;
+  return label;
+}
+
+double GridBeliefPropagation::getLogZ() const {
+  const double potts = exp(mStrength);
+  double logZ = 0;
+  Buffer belief(mNumLabels);
+  Buffer cavity(mNumLabels);
+  Buffer neighbourCavity(mNumLabels);
+  for (size_t cell = 0; cell < getNumCells(); ++cell) {
+    if (!mVertices[cell])
+      continue;
+    size_t degree = 0;
+    for (size_t d = 0; d < numDirections; ++d) {
+      size_t neighbour;
+      if (getNeighbour(cell, static_cast<Direction>(d), neighbour))
+        degree++;
+    }
+    computeCavity(cell, numDirections, belief);
+    normalize(belief);
+    for (size_t i = 0; i < mNumLabels; ++i)
+      if (belief(i) > 0)
+        logZ += belief(i) * (log(mNodePotentials(i, cell)) +
+          (degree - 1.0) * log(belief(i)));
+    const Direction forward[] = {right, down};
+    for (size_t d = 0; d < 2; ++d) {
+      size_t neighbour;
+      if (!getNeighbour(cell, forward[d], neighbour))
+        continue;
+      computeCavity(cell, forward[d], cavity);
+      normalize(cavity);
+      computeCavity(neighbour, forward[d] ^ 1, neighbourCavity);
+      normalize(neighbourCavity);
+      const double z = 1.0 + (potts - 1.0) * cavity.dot(neighbourCavity);
+      logZ += log(z);
+      for (size_t i = 0; i < mNumLabels; ++i) {
+        if (cavity(i) > 0)
+          logZ -= cavity(i) * (1.0 + (potts - 1.0) * neighbourCavity(i)) /
+            z * log(cavity(i));
+        if (neighbourCavity(i) > 0)
+          logZ -= neighbourCavity(i) * (1.0 + (potts - 1.0) * cavity(i)) /
+            z * log(neighbourCavity(i));
+      }
+    }
+  }
+  return logZ;
+}
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+void GridBeliefPropagation::resize(size_t numRows, size_t numCols,
+    size_t numLabels) {
+  PottsGrid::resize(numRows, numCols, numLabels);
+  const size_t numCells = getNumCells();
+  mMessages.assign(numDirections, Potentials());
+  if (numCells) {
+    for (size_t d = 0; d < numDirections; ++d)
+      mMessages[d].resize(numLabels, numCells);
+    mBeliefs.resize(numLabels, numCells);
+  }
+  init();
+}
+
+void GridBeliefPropagation::init() {
+  const double uniform = mLogDomain ? 0.0 : 1.0 / mNumLabels;
+  for (size_t d = 0; d < mMessages.size(); ++d)
+    mMessages[d].setConstant(uniform);
+  mBeliefs.setZero();
+  mWarmStart = false;
+  mNumIter = 0;
+  mMaxDiff = 0;
+}
+
+size_t GridBeliefPropagation::run() {
+  ThreadPool pool(mSchedule == checkerboard ? mNumThreads : 1);
+  return run(pool);
+}
+
+size_t GridBeliefPropagation::run(ThreadPool& pool) {
+  const Clock::Nanoseconds start = Clock::now();
+  mPotts = exp(mStrength);
+  if (mLogDomain)
+    mLogPotentials = mNodePotentials.cwise().log();
+  if (!mWarmStart && mNumLevels > 1 && (mNumRows > 1 || mNumCols > 1))
+    initFromCoarser(pool);
+  const size_t numCells = getNumCells();
+  Buffer buffer(mNumLabels);
+  Buffer previous(mNumLabels);
+  mRowDiffs.assign(mNumRows, 0);
+  mRowResiduals.assign(mNumRows, 0);
+  mIterationStats.clear();
+  size_t numMessages = 0;
+  for (size_t cell = 0; cell < numCells; ++cell)
+    for (size_t d = 0; d < numDirections; ++d) {
+      size_t neighbour;
+      if (mVertices[cell] &&
+          getNeighbour(cell, static_cast<Direction>(d), neighbour))
+        numMessages++;
+    }
+  if (mSchedule == residual) {
+    mPendingMessages = mMessages;
+    mResiduals.assign(numDirections * numCells, 0);
+    mHeapPositions.assign(numDirections * numCells, (size_t)-1);
+    mHeap.clear();
+    mHeap.reserve(numMessages);
+    for (size_t cell = 0; cell < numCells; ++cell)
+      if (mVertices[cell])
+        updatePending(cell, numDirections, buffer);
+  }
+  mMaxDiff = std::numeric_limits<double>::infinity();
+  for (mNumIter = 0; mNumIter < mMaxNumIter && mMaxDiff > mTol; ++mNumIter) {
+    if (mNumIter > 0 && mTimeBudget > 0 &&
+        Clock::getSeconds(Clock::now() - start) >= mTimeBudget)
+      break;
+    IterationStats stats;
+    stats.mNumUpdates = numMessages;
+    stats.mMaxResidual = 0;
+    if (mSchedule == checkerboard) {
+      RowTask redTask(*this, redMessages);
+      pool.process(redTask, mNumRows);
+      RowTask blackTask(*this, blackMessages);
+      pool.process(blackTask, mNumRows);
+      RowTask beliefsTask(*this, beliefs);
+      pool.process(beliefsTask, mNumRows);
+      for (size_t row = 0; row < mNumRows; ++row)
+        stats.mMaxResidual = std::max(stats.mMaxResidual,
+          mRowResiduals[row]);
+    }
+    else {
+      if (mSchedule == residual)
+        stats.mMaxResidual = processResiduals(numMessages, buffer,
+          stats.mNumUpdates);
+      else {
+        for (size_t cell = 0; cell < numCells; ++cell)
+          if (mVertices[cell]) {
+            stats.mMaxResidual = std::max(stats.mMaxResidual,
+              updateMessage(cell, right, buffer, previous));
+            stats.mMaxResidual = std::max(stats.mMaxResidual,
+              updateMessage(cell, down, buffer, previous));
+          }
+        for (size_t cell = numCells; cell > 0; --cell)
+          if (mVertices[cell - 1]) {
+            stats.mMaxResidual = std::max(stats.mMaxResidual,
+              updateMessage(cell - 1, left, buffer, previous));
+            stats.mMaxResidual = std::max(stats.mMaxResidual,
+              updateMessage(cell - 1, up, buffer, previous));
+          }
+      }
+      for (size_t row = 0; row < mNumRows; ++row)
+        processRow(row, beliefs);
+    }
+    mMaxDiff = 0;
+    for (size_t row = 0; row < mNumRows; ++row)
+      mMaxDiff = std::max(mMaxDiff, mRowDiffs[row]);
+    stats.mTime = Clock::getSeconds(Clock::now() - start);
+    mIterationStats.push_back(stats);
+  }
+  mWarmStart = true;
+  return mNumIter;
+}
+
+double GridBeliefPropagation::processResiduals(size_t maxNumUpdates,
+    Buffer& buffer, size_t& numUpdates) {
+  const size_t numCells = getNumCells();
+  double maxResidual = 0;
+  for (numUpdates = 0; numUpdates < maxNumUpdates && !mHeap.empty();
+      ++numUpdates) {
+    const size_t message = mHeap[0];
+    const size_t direction = message / numCells;
+    const size_t cell = message % numCells;
+    maxResidual = std::max(maxResidual, mResiduals[message]);
+    mMessages[direction].col(cell) = mPendingMessages[direction].col(cell);
+    setResidual(message, 0);
+    updatePending(cell, direction, buffer);
+  }
+  return maxResidual;
+}
+
+void GridBeliefPropagation::updatePending(size_t cell, size_t excluded,
+    Buffer& buffer) {
+  for (size_t d = 0; d < numDirections; ++d) {
+    size_t neighbour;
+    if (d == excluded ||
+        !getNeighbour(cell, static_cast<Direction>(d), neighbour))
+      continue;
+    computeMessage(cell, static_cast<Direction>(d), neighbour, buffer,
+      mPendingMessages[d ^ 1]);
+    setResidual((d ^ 1) * getNumCells() + neighbour,
+      (mPendingMessages[d ^ 1].col(neighbour) -
+      mMessages[d ^ 1].col(neighbour)).cwise().abs().maxCoeff());
+  }
+}
+
+void GridBeliefPropagation::setResidual(size_t message, double residual) {
+  mResiduals[message] = residual;
+  size_t position = mHeapPositions[message];
+  if (!(residual > mTol)) {
+    if (position == (size_t)-1)
+      return;
+    mHeapPositions[message] = (size_t)-1;
+    message = mHeap.back();
+    mHeap.pop_back();
+    if (position == mHeap.size())
+      return;
+    residual = mResiduals[message];
+  }
+  else if (position == (size_t)-1) {
+    position = mHeap.size();
+    mHeap.push_back(message);
+  }
+  while (position > 0 && mResiduals[mHeap[(position - 1) / 2]] < residual) {
+    mHeap[position] = mHeap[(position - 1) / 2];
+    mHeapPositions[mHeap[position]] = position;
+    position = (position - 1) / 2;
+  }
+  while (2 * position + 1 < mHeap.size()) {
+    size_t child = 2 * position + 1;
+    if (child + 1 < mHeap.size() &&
+        mResiduals[mHeap[child + 1]] > mResiduals[mHeap[child]])
+      child++;
+    if (!(mResiduals[mHeap[child]] > residual))
+      break;
+    mHeap[position] = mHeap[child];
+    mHeapPositions[mHeap[position]] = position;
+    position = child;
+  }
+  mHeap[position] = message;
+  mHeapPositions[message] = position;
+}
+
+void GridBeliefPropagation::initFromCoarser(ThreadPool& pool) {
+  GridBeliefPropagation coarse((mNumRows + 1) / 2, (mNumCols + 1) / 2,
+    mNumLabels, std::min(2.0 * mStrength, maxCoarseStrength), mMaxNumIter,
+    mTol, mInference, mLogDomain, mSchedule, mNumThreads);
+  coarse.setNumLevels(mNumLevels - 1);
+  coarse.setTimeBudget(0.5 * mTimeBudget);
+  const size_t numCells = getNumCells();
+  const size_t numCoarseCells = coarse.getNumCells();
+  std::vector<size_t> parents(numCells);
+  Potentials logPotentials = Potentials::Zero(mNumLabels, numCoarseCells);
+  for (size_t cell = 0; cell < numCells; ++cell) {
+    parents[cell] = (cell / mNumCols / 2) * coarse.mNumCols +
+      (cell % mNumCols) / 2;
+    if (mVertices[cell]) {
+      coarse.mVertices[parents[cell]] = true;
+      logPotentials.col(parents[cell]) +=
+        mNodePotentials.col(cell).cwise().log();
+    }
+  }
+  for (size_t cell = 0; cell < numCoarseCells; ++cell)
+    if (coarse.mVertices[cell]) {
+      const double maxValue = logPotentials.col(cell).maxCoeff();
+      if (maxValue == -std::numeric_limits<double>::infinity())
+        coarse.mNodePotentials.col(cell).setConstant(1.0);
+      else
+        coarse.mNodePotentials.col(cell) =
+          (logPotentials.col(cell).cwise() - maxValue).cwise().exp();
+    }
+  coarse.run(pool);
+  const double uniform = mLogDomain ? 0.0 : 1.0 / mNumLabels;
+  for (size_t cell = 0; cell < numCells; ++cell)
+    for (size_t d = 0; d < numDirections; ++d) {
+      size_t neighbour;
+      if (mVertices[cell] &&
+          getNeighbour(cell, static_cast<Direction>(d), neighbour))
+        mMessages[d].col(cell) = coarse.mMessages[d].col(parents[cell]);
+      else
+        mMessages[d].col(cell).setConstant(uniform);
+    }
+  mBeliefs.setZero();
+}
+
+void GridBeliefPropagation::RowTask::process(size_t row) {
+  mBP.processRow(row, mStep);
+}
+
+void GridBeliefPropagation::processRow(size_t row, Step step) {
+  Buffer buffer(mNumLabels);
+  Buffer previous(mNumLabels);
+  if (step == beliefs) {
+    double maxDiff = 0;
+    for (size_t cell = row * mNumCols; cell < (row + 1) * mNumCols; ++cell)
+      if (mVertices[cell]) {
+        computeCavity(cell, numDirections, buffer);
+        normalize(buffer);
+        maxDiff = std::max(maxDiff,
+          (buffer - mBeliefs.col(cell)).cwise().abs().maxCoeff());
+        mBeliefs.col(cell) = buffer;
+      }
+    mRowDiffs[row] = maxDiff;
+    return;
+  }
+  const size_t colour = (step == redMessages) ? 0 : 1;
+  double maxResidual = (step == redMessages) ? 0.0 : mRowResiduals[row];
+  for (size_t col = (row + colour) % 2; col < mNumCols; col += 2) {
+    const size_t cell = row * mNumCols + col;
+    if (mVertices[cell])
+      for (size_t d = 0; d < numDirections; ++d)
+        maxResidual = std::max(maxResidual, updateMessage(cell,
+          static_cast<Direction>(d), buffer, previous));
+  }
+  mRowResiduals[row] = maxResidual;
+}
+
+void GridBeliefPropagation::computeCavity(size_t cell, size_t excluded,
+    Buffer& buffer) const {
+  if (mLogDomain) {
+    buffer = mLogPotentials.col(cell);
+    for (size_t d = 0; d < numDirections; ++d)
+      if (d != excluded)
+        buffer += mMessages[d].col(cell);
+  }
+  else {
+    buffer = mNodePotentials.col(cell);
+    for (size_t d = 0; d < numDirections; ++d)
+      if (d != excluded)
+        buffer.cwise() *= mMessages[d].col(cell);
+  }
+}
+
+void GridBeliefPropagation::normalize(Buffer& buffer) const {
+  if (mLogDomain) {
+    const double maxValue = buffer.maxCoeff();
+    if (maxValue == -std::numeric_limits<double>::infinity()) {
+      buffer.setConstant(1.0 / mNumLabels);
+      return;
+    }
+    buffer = (buffer.cwise() - maxValue).cwise().exp();
+  }
+  const double sum = buffer.sum();
+  if (sum > 0)
+    buffer /= sum;
+  else
+    buffer.setConstant(1.0 / mNumLabels);
+}
+
+double GridBeliefPropagation::updateMessage(size_t cell, Direction direction,
+    Buffer& buffer, Buffer& previous) {
+  size_t neighbour;
+  if (!getNeighbour(cell, direction, neighbour))
+    return 0;
+  Potentials& messages = mMessages[direction ^ 1];
+  previous = messages.col(neighbour);
+  computeMessage(cell, direction, neighbour, buffer, messages);
+  return (messages.col(neighbour) - previous).cwise().abs().maxCoeff();
+}
+
+void GridBeliefPropagation::computeMessage(size_t cell, Direction direction,
+    size_t neighbour, Buffer& buffer, Potentials& messages) const {
+  computeCavity(cell, direction, buffer);
+  const double maxCavity = buffer.maxCoeff();
+  if (mLogDomain) {
+    if (maxCavity == -std::numeric_limits<double>::infinity()) {
+      messages.col(neighbour).setZero();
+      return;
+    }
+    if (mInference == maxProduct)
+      for (size_t i = 0; i < mNumLabels; ++i)
+        messages(i, neighbour) = std::max(buffer(i) - maxCavity, -mStrength);
+    else {
+      buffer = (buffer.cwise() - maxCavity).cwise().exp();
+      const double sum = buffer.sum();
+      const double norm = log(sum + mPotts - 1.0);
+      for (size_t i = 0; i < mNumLabels; ++i)
+        messages(i, neighbour) = log(sum + (mPotts - 1.0) * buffer(i)) - norm;
+    }
+  }
+  else {
+    if (!(maxCavity > 0)) {
+      messages.col(neighbour).setConstant(1.0 / mNumLabels);
+      return;
+    }
+    if (mInference == maxProduct) {
+      double sum = 0;
+      for (size_t i = 0; i < mNumLabels; ++i) {
+        messages(i, neighbour) = std::max(mPotts * buffer(i) / maxCavity, 1.0);
+        sum += messages(i, neighbour);
+      }
+      messages.col(neighbour) /= sum;
+    }
+    else {
+      const double sum = buffer.sum();
+      const double norm = sum * (mNumLabels + mPotts - 1.0);
+      for (size_t i = 0; i < mNumLabels; ++i)
+        messages(i, neighbour) = (sum + (mPotts - 1.0) * buffer(i)) / norm;
+    }
+  }
+}
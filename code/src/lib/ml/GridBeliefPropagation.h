@@ -0,0 +1,289 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file GridBeliefPropagation.h
+    \brief This file defines the GridBeliefPropagation class which implements
+           loopy Belief Propagation (BP) on 4-connected grids with Potts
+           pairwise factors.
+  */
+
+#ifndef GRIDBELIEFPROPAGATION_H
+#define GRIDBELIEFPROPAGATION_H
+
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "ml/PottsGrid.h"
+#include "base/ThreadPool.h"
+
+/** The class GridBeliefPropagation implements loopy BP on a 4-connected grid
+    with Potts pairwise factors exp(strength) on the diagonal and 1 elsewhere.
+    Messages are stored per direction in flat arrays of one column per cell,
+    so that a Potts message update costs O(K) instead of O(K^2). Messages are
+    either updated with a forward raster sweep followed by a backward one,
+    with a red-black (checkerboard) schedule where all cells of one colour
+    send their messages concurrently on a thread pool, or by residual BP
+    (Elidan et al.), which always sends the pending message that changed the
+    most. Each iteration records its largest message change, its number of
+    updates and its time, and runs can be capped by a time budget in
+    addition to the number of iterations. With more than one level, the
+    messages are initialized coarse-to-fine from BP on grids of 2x2 blocks
+    of cells (Felzenszwalb and Huttenlocher). Successive runs without init()
+    are warm-started from the previous messages, so that only the node
+    potentials need to be refreshed between runs.
+    \brief Loopy BP on 4-connected Potts grids
+  */
+class GridBeliefPropagation :
+  public PottsGrid {
+public:
+  /** \name Types definitions
+    @{
+    */
+  /// Inference types
+  enum Inference {
+    /// Sum-product for marginals
+    sumProduct,
+    /// Max-product for MAP labelling
+    maxProduct
+  };
+  /// Message update schedules
+  enum Schedule {
+    /// Forward and backward raster sweeps
+    sequential,
+    /// Parallel red-black updates
+    checkerboard,
+    /// Largest message change first (residual BP)
+    residual
+  };
+  /// Convergence statistics of an iteration
+  struct IterationStats {
+    /// Maximum change of the updated messages
+    double mMaxResidual;
+    /// Number of messages updated
+    size_t mNumUpdates;
+    /// Time elapsed since the start of the run in seconds
+    double mTime;
+  };
+  /// Buffer type for a single cell
+  typedef Eigen::Matrix<double, Eigen::Dynamic, 1> Buffer;
+  /** @}
+    */
+
+  /** \name Constructors/destructor
+    @{
+    */
+  /// Constructs BP on a grid with all cells disabled
+  GridBeliefPropagation(size_t numRows = 0, size_t numCols = 0,
+    size_t numLabels = 1, double strength = 10.0, size_t maxNumIter = 200,
+    double tol = 1e-9, Inference inference = maxProduct,
+    bool logDomain = false, Schedule schedule = sequential,
+    size_t numThreads = 1);
+  /// Copy constructor
+  GridBeliefPropagation(const GridBeliefPropagation& other);
+  /// Assignment operator
+  GridBeliefPropagation& operator = (const GridBeliefPropagation& other);
+  /// Destructor
+  virtual ~GridBeliefPropagation();
+  /** @}
+    */
+
+  /** \name Accessors
+    @{
+    */
+  /// Returns the maximum number of iterations
+  size_t getMaxNumIter() const;
+  /// Sets the maximum number of iterations
+  void setMaxNumIter(size_t maxNumIter);
+  /// Returns the tolerance on the beliefs change
+  double getTolerance() const;
+  /// Sets the tolerance on the beliefs change
+  void setTolerance(double tol);
+  /// Returns the inference type
+  Inference getInference() const;
+  /// Sets the inference type
+  void setInference(Inference inference);
+  /// Returns the log-domain flag
+  bool getLogDomain() const;
+  /// Sets the log-domain flag
+  void setLogDomain(bool logDomain);
+  /// Returns the update schedule
+  Schedule getSchedule() const;
+  /// Sets the update schedule
+  void setSchedule(Schedule schedule);
+  /// Returns the number of threads of the checkerboard schedule
+  size_t getNumThreads() const;
+  /// Sets the number of threads (0 means one per CPU)
+  void setNumThreads(size_t numThreads);
+  /// Returns the number of levels of the coarse-to-fine initialization
+  size_t getNumLevels() const;
+  /// Sets the number of levels of the coarse-to-fine initialization
+  void setNumLevels(size_t numLevels);
+  /// Returns true if the next run is warm-started from the messages
+  bool getWarmStart() const;
+  /// Returns the time budget of a run in seconds (0 means unlimited)
+  double getTimeBudget() const;
+  /// Sets the time budget of a run in seconds (0 means unlimited)
+  void setTimeBudget(double timeBudget);
+  /// Returns the number of iterations of the last run
+  size_t getNumIterations() const;
+  /// Returns the convergence statistics of the iterations of the last run
+  const std::vector<IterationStats>& getIterationStats() const;
+  /// Returns the maximum beliefs change of the last iteration
+  double getMaxDiff() const;
+  /// Returns the normalized beliefs, one column per cell
+  const Potentials& getBeliefs() const;
+  /// Returns the MAP label of a cell
+  virtual size_t getLabel(size_t cell) const;
+  /// Returns the Bethe approximation of the log-partition function
+  double getLogZ() const;
+  /** @}
+    */
+
+  /** \name Methods
+    @{
+    */
+  /// Resizes the grid and disables all cells
+  virtual void resize(size_t numRows, size_t numCols, size_t numLabels);
+  /// Resets the messages to uniform
+  void init();
+  /// Runs BP until convergence / Returns the number of iterations
+  virtual size_t run();
+  /// Runs BP on a thread pool / Returns the number of iterations
+  size_t run(ThreadPool& pool);
+  /** @}
+    */
+
+protected:
+  /** \name Protected types
+    @{
+    */
+  /// Steps performed on the rows of the grid
+  enum Step {
+    /// Messages sent by the red cells
+    redMessages,
+    /// Messages sent by the black cells
+    blackMessages,
+    /// Beliefs update
+    beliefs
+  };
+  /// Task processing the rows of the grid in parallel
+  class RowTask :
+    public ThreadPool::Task {
+  public:
+    /// Constructs task from BP and step
+    RowTask(GridBeliefPropagation& bp, Step step);
+    /// Process a row
+    virtual void process(size_t row);
+  protected:
+    /// BP
+    GridBeliefPropagation& mBP;
+    /// Step to perform
+    Step mStep;
+  };
+  /** @}
+    */
+
+  /** \name Protected methods
+    @{
+    */
+  /// Computes the product of the potential and the incoming messages
+  void computeCavity(size_t cell, size_t excluded, Buffer& buffer) const;
+  /// Converts a cavity to normalized probabilities
+  void normalize(Buffer& buffer) const;
+  /// Computes the message from a cell to its neighbour into a column
+  void computeMessage(size_t cell, Direction direction, size_t neighbour,
+    Buffer& buffer, Potentials& messages) const;
+  /// Sends the message from a cell to its neighbour / Returns the change
+  double updateMessage(size_t cell, Direction direction, Buffer& buffer,
+    Buffer& previous);
+  /// Updates messages by largest residual / Returns the largest change
+  double processResiduals(size_t maxNumUpdates, Buffer& buffer,
+    size_t& numUpdates);
+  /// Recomputes the pending messages sent by a cell except in a direction
+  void updatePending(size_t cell, size_t excluded, Buffer& buffer);
+  /// Changes the residual of a message in the priority queue
+  void setResidual(size_t message, double residual);
+  /// Initializes the messages from BP on a coarser grid
+  void initFromCoarser(ThreadPool& pool);
+  /// Performs a step on a row of the grid
+  void processRow(size_t row, Step step);
+  /** @}
+    */
+
+  /** \name Protected static members
+    @{
+    */
+  /// Largest Potts strength of the coarse levels, keeping exp() finite
+  static const double maxCoarseStrength;
+  /** @}
+    */
+
+  /** \name Protected members
+    @{
+    */
+  /// Node potentials in the log-domain
+  Potentials mLogPotentials;
+  /// Incoming messages of each cell per direction of the sender
+  std::vector<Potentials> mMessages;
+  /// Normalized beliefs
+  Potentials mBeliefs;
+  /// Potts diagonal factor exp(strength)
+  double mPotts;
+  /// Maximum number of iterations
+  size_t mMaxNumIter;
+  /// Tolerance on the beliefs change
+  double mTol;
+  /// Inference type
+  Inference mInference;
+  /// Log-domain flag
+  bool mLogDomain;
+  /// Update schedule
+  Schedule mSchedule;
+  /// Number of threads of the checkerboard schedule
+  size_t mNumThreads;
+  /// Number of levels of the coarse-to-fine initialization
+  size_t mNumLevels;
+  /// Maximum beliefs change per row
+  std::vector<double> mRowDiffs;
+  /// Maximum messages change per row
+  std::vector<double> mRowResiduals;
+  /// Pending messages of the residual schedule
+  std::vector<Potentials> mPendingMessages;
+  /// Residuals of the pending messages, indexed by direction and cell
+  std::vector<double> mResiduals;
+  /// Max-heap of the messages with a residual above the tolerance
+  std::vector<size_t> mHeap;
+  /// Positions of the messages in the heap
+  std::vector<size_t> mHeapPositions;
+  /// Time budget of a run in seconds
+  double mTimeBudget;
+  /// Warm start flag
+  bool mWarmStart;
+  /// Number of iterations of the last run
+  size_t mNumIter;
+  /// Maximum beliefs change of the last iteration
+  double mMaxDiff;
+  /// Convergence statistics of the iterations of the last run
+  std::vector<IterationStats> mIterationStats;
+  /** @}
+    */
+
+};
+
+#endif // GRIDBELIEFPROPAGATION_H
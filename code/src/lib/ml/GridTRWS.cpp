@@ -0,0 +1,223 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include "ml/GridTRWS.h"
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+#include "exceptions/OutOfBoundException.h"
+
+/******************************************************************************/
+/* Constructors and Destructor                                                */
+/******************************************************************************/
+
+GridTRWS::GridTRWS(size_t numRows, size_t numCols, size_t numLabels,
+    double strength, size_t maxNumIter, double tol) :
+    PottsGrid(numRows, numCols, numLabels, strength),
+    mMaxNumIter(maxNumIter),
+    mTol(tol),
+    mNumIter(0),
+    mLowerBound(-std::numeric_limits<double>::infinity()) {
+}
+
+GridTRWS::GridTRWS(const GridTRWS& other) :
+    PottsGrid(other),
+    mMessages(other.mMessages),
+    mCosts(other.mCosts),
+    mChainCosts(other.mChainCosts),
+    mLabels(other.mLabels),
+    mCandidateLabels(other.mCandidateLabels),
+    mBelief(other.mBelief),
+    mMaxNumIter(other.mMaxNumIter),
+    mTol(other.mTol),
+    mNumIter(other.mNumIter),
+    mLowerBound(other.mLowerBound) {
+}
+
+GridTRWS& GridTRWS::operator = (const GridTRWS& other) {
+  if (this != &other) {
+    PottsGrid::operator=(other);
+    mMessages = other.mMessages;
+    mCosts = other.mCosts;
+    mChainCosts = other.mChainCosts;
+    mLabels = other.mLabels;
+    mCandidateLabels = other.mCandidateLabels;
+    mBelief = other.mBelief;
+    mMaxNumIter = other.mMaxNumIter;
+    mTol = other.mTol;
+    mNumIter = other.mNumIter;
+    mLowerBound = other.mLowerBound;
+  }
+  return *this;
+}
+
+GridTRWS::~GridTRWS() {
+}
+
+/******************************************************************************/
+/* Accessors                                                                  */
+/******************************************************************************/
+
+size_t GridTRWS::getMaxNumIter() const {
+  return mMaxNumIter;
+}
+
+void GridTRWS::setMaxNumIter(size_t maxNumIter) {
+  mMaxNumIter = maxNumIter;
+}
+
+double GridTRWS::getTol() const {
+  return mTol;
+}
+
+void GridTRWS::setTol(double tol) {
+  mTol = tol;
+}
+
+size_t GridTRWS::getNumIterations() const {
+  return mNumIter;
+}
+
+double GridTRWS::getLowerBound() const {
+  return mLowerBound;
+}
+
+size_t GridTRWS::getLabel(size_t cell) const {
+  if (cell >= getNumCells())
+    throw OutOfBoundException<size_t>(cell,
+      "GridTRWS::getLabel(): cell out of range", __FILE__, __LINE__);
+  return cell < mLabels.size() ? mLabels[cell] : 0;
+}
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+size_t GridTRWS::run() {
+  const size_t numCells = getNumCells();
+  mCosts = Potentials::Zero(mNumLabels, numCells);
+  for (size_t cell = 0; cell < numCells; ++cell)
+    if (mVertices[cell])
+      for (size_t i = 0; i < mNumLabels; ++i)
+        mCosts(i, cell) = getCost(i, cell);
+  mMessages.assign(numDirections, Potentials::Zero(mNumLabels, numCells));
+  mChainCosts = Potentials::Zero(mNumLabels, numCells);
+  mLabels.assign(numCells, 0);
+  mCandidateLabels.assign(numCells, 0);
+  mBelief.resize(mNumLabels);
+  mLowerBound = -std::numeric_limits<double>::infinity();
+  double energy = std::numeric_limits<double>::infinity();
+  const Direction forward[] = {right, down};
+  const Direction backward[] = {left, up};
+  for (mNumIter = 0; mNumIter < mMaxNumIter; ) {
+    for (size_t cell = 0; cell < numCells; ++cell)
+      if (mVertices[cell]) {
+        decodeLabel(cell);
+        sendMessages(cell, forward);
+      }
+    for (size_t cell = numCells; cell > 0; --cell)
+      if (mVertices[cell - 1])
+        sendMessages(cell - 1, backward);
+    ++mNumIter;
+    const double candidateEnergy = computeEnergy(mCandidateLabels);
+    if (candidateEnergy < energy) {
+      energy = candidateEnergy;
+      mLabels = mCandidateLabels;
+    }
+    const double lowerBound = computeChainsBound(left) +
+      computeChainsBound(up);
+    const bool stalled = lowerBound - mLowerBound <= mTol * fabs(lowerBound);
+    mLowerBound = std::max(mLowerBound, lowerBound);
+    if (energy - mLowerBound <= mTol * fabs(energy) || stalled)
+      break;
+  }
+  return mNumIter;
+}
+
+void GridTRWS::computeBelief(size_t cell, std::vector<double>& belief)
+    const {
+  for (size_t i = 0; i < mNumLabels; ++i)
+    belief[i] = mCosts(i, cell) + mMessages[left](i, cell) +
+      mMessages[right](i, cell) + mMessages[up](i, cell) +
+      mMessages[down](i, cell);
+}
+
+void GridTRWS::sendMessages(size_t cell, const Direction* directions) {
+  computeBelief(cell, mBelief);
+  for (size_t d = 0; d < 2; ++d) {
+    size_t neighbour;
+    if (!getNeighbour(cell, directions[d], neighbour))
+      continue;
+    const Potentials& reverse = mMessages[directions[d]];
+    double minValue = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < mNumLabels; ++i)
+      minValue = std::min(minValue, 0.5 * mBelief[i] - reverse(i, cell));
+    Potentials& messages = mMessages[directions[d] ^ 1];
+    for (size_t i = 0; i < mNumLabels; ++i)
+      messages(i, neighbour) = std::min(0.5 * mBelief[i] - reverse(i, cell) -
+        minValue, mStrength);
+  }
+}
+
+void GridTRWS::decodeLabel(size_t cell) {
+  for (size_t i = 0; i < mNumLabels; ++i)
+    mBelief[i] = mCosts(i, cell) + mMessages[right](i, cell) +
+      mMessages[down](i, cell);
+  const Direction backward[] = {left, up};
+  for (size_t d = 0; d < 2; ++d) {
+    size_t neighbour;
+    if (getNeighbour(cell, backward[d], neighbour))
+      mBelief[mCandidateLabels[neighbour]] -= mStrength;
+  }
+  mCandidateLabels[cell] = std::min_element(mBelief.begin(), mBelief.end()) -
+    mBelief.begin();
+}
+
+double GridTRWS::computeChainsBound(Direction direction) {
+  double bound = 0;
+  const Direction next = static_cast<Direction>(direction ^ 1);
+  for (size_t cell = 0; cell < getNumCells(); ++cell) {
+    if (!mVertices[cell])
+      continue;
+    computeBelief(cell, mBelief);
+    size_t previous;
+    if (getNeighbour(cell, direction, previous)) {
+      double minValue = std::numeric_limits<double>::infinity();
+      for (size_t i = 0; i < mNumLabels; ++i)
+        minValue = std::min(minValue, mChainCosts(i, previous) -
+          mMessages[next](i, previous));
+      for (size_t i = 0; i < mNumLabels; ++i)
+        mChainCosts(i, cell) = 0.5 * mBelief[i] - mMessages[direction](i,
+          cell) + std::min(mChainCosts(i, previous) -
+          mMessages[next](i, previous), minValue + mStrength);
+    }
+    else
+      for (size_t i = 0; i < mNumLabels; ++i)
+        mChainCosts(i, cell) = 0.5 * mBelief[i];
+    size_t neighbour;
+    if (!getNeighbour(cell, next, neighbour)) {
+      double minValue = mChainCosts(0, cell);
+      for (size_t i = 1; i < mNumLabels; ++i)
+        minValue = std::min(minValue, mChainCosts(i, cell));
+      bound += minValue;
+    }
+  }
+  return bound;
+}
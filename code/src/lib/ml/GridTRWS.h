@@ -0,0 +1,132 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file GridTRWS.h
+    \brief This file defines the GridTRWS class, which computes MAP labelings
+           of Potts grids with sequential tree-reweighted message passing.
+  */
+
+#ifndef GRIDTRWS_H
+#define GRIDTRWS_H
+
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "ml/PottsGrid.h"
+
+/** The class GridTRWS implements sequential tree-reweighted message passing
+    (TRW-S, Kolmogorov) on 4-connected grids with Potts pairwise factors. The
+    grid is decomposed into its row and column chains, and messages are
+    passed in min-sum form with a forward raster sweep followed by a backward
+    one. Unlike max-product BP, the lower bound given by the chains never
+    decreases, so that the iterations stop as soon as the gap between the
+    energy of the best labeling and the bound is small, or when the bound
+    stops increasing.
+    \brief TRW-S MAP labeling of Potts grids
+  */
+class GridTRWS :
+  public PottsGrid {
+public:
+  /** \name Constructors/destructor
+    @{
+    */
+  /// Constructs TRW-S on a grid with all cells disabled
+  GridTRWS(size_t numRows = 0, size_t numCols = 0, size_t numLabels = 1,
+    double strength = 10.0, size_t maxNumIter = 200, double tol = 1e-6);
+  /// Copy constructor
+  GridTRWS(const GridTRWS& other);
+  /// Assignment operator
+  GridTRWS& operator = (const GridTRWS& other);
+  /// Destructor
+  virtual ~GridTRWS();
+  /** @}
+    */
+
+  /** \name Accessors
+    @{
+    */
+  /// Returns the maximum number of iterations
+  size_t getMaxNumIter() const;
+  /// Sets the maximum number of iterations
+  void setMaxNumIter(size_t maxNumIter);
+  /// Returns the relative tolerance on the gap and bound increase
+  double getTol() const;
+  /// Sets the relative tolerance on the gap and bound increase
+  void setTol(double tol);
+  /// Returns the number of iterations of the last run
+  size_t getNumIterations() const;
+  /// Returns the lower bound on the energy of the last run
+  double getLowerBound() const;
+  /// Returns the label of a cell
+  virtual size_t getLabel(size_t cell) const;
+  /** @}
+    */
+
+  /** \name Methods
+    @{
+    */
+  /// Runs TRW-S until convergence / Returns the number of iterations
+  virtual size_t run();
+  /** @}
+    */
+
+protected:
+  /** \name Protected methods
+    @{
+    */
+  /// Computes the reparametrized unary costs of a cell
+  void computeBelief(size_t cell, std::vector<double>& belief) const;
+  /// Sends the messages of a cell in two directions
+  void sendMessages(size_t cell, const Direction* directions);
+  /// Chooses the label of a cell given the labels of preceding cells
+  void decodeLabel(size_t cell);
+  /// Returns the lower bound of the chains along a direction
+  double computeChainsBound(Direction direction);
+  /** @}
+    */
+
+  /** \name Protected members
+    @{
+    */
+  /// Messages into the cells, one array per incoming direction
+  std::vector<Potentials> mMessages;
+  /// Unary costs of the cells
+  Potentials mCosts;
+  /// Minimum energies of the chains up to the cells
+  Potentials mChainCosts;
+  /// Labels of the best labeling
+  std::vector<size_t> mLabels;
+  /// Labels decoded at the current iteration
+  std::vector<size_t> mCandidateLabels;
+  /// Buffer for the reparametrized unary costs
+  std::vector<double> mBelief;
+  /// Maximum number of iterations
+  size_t mMaxNumIter;
+  /// Relative tolerance on the gap and bound increase
+  double mTol;
+  /// Number of iterations of the last run
+  size_t mNumIter;
+  /// Lower bound on the energy
+  double mLowerBound;
+  /** @}
+    */
+
+};
+
+#endif // GRIDTRWS_H
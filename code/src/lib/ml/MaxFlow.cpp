@@ -0,0 +1,322 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include "ml/MaxFlow.h"
+
+#include <algorithm>
+
+#include "exceptions/OutOfBoundException.h"
+
+/******************************************************************************/
+/* Constructors and Destructor                                                */
+/******************************************************************************/
+
+MaxFlow::MaxFlow(size_t numNodes) {
+  reset(numNodes);
+}
+
+MaxFlow::~MaxFlow() {
+}
+
+/******************************************************************************/
+/* Accessors                                                                  */
+/******************************************************************************/
+
+size_t MaxFlow::getNumNodes() const {
+  return mNumNodes;
+}
+
+double MaxFlow::getFlow() const {
+  return mFlow;
+}
+
+bool MaxFlow::isSourceSide(size_t node) const {
+  if (node >= mNumNodes)
+    throw OutOfBoundException<size_t>(node,
+      "MaxFlow::isSourceSide(): node out of range", __FILE__, __LINE__);
+  return mNodes[node].mParent != noParent && !mNodes[node].mSinkTree;
+}
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+void MaxFlow::reset(size_t numNodes) {
+  Node node;
+  node.mParent = noParent;
+  node.mTimestamp = 0;
+  node.mDistance = 0;
+  node.mTerminalCapacity = 0;
+  node.mSinkTree = false;
+  node.mActive = false;
+  mNumNodes = numNodes;
+  mNodes.assign(numNodes, node);
+  mEdges.clear();
+  mActiveNodes.clear();
+  mOrphans.clear();
+  mTime = 0;
+  mFlow = 0;
+}
+
+void MaxFlow::addTerminalEdges(size_t node, double sourceCapacity,
+    double sinkCapacity) {
+  if (node >= mNumNodes)
+    throw OutOfBoundException<size_t>(node,
+      "MaxFlow::addTerminalEdges(): node out of range", __FILE__, __LINE__);
+  const double capacity = mNodes[node].mTerminalCapacity;
+  if (capacity > 0)
+    sourceCapacity += capacity;
+  else
+    sinkCapacity -= capacity;
+  mFlow += std::min(sourceCapacity, sinkCapacity);
+  mNodes[node].mTerminalCapacity = sourceCapacity - sinkCapacity;
+}
+
+void MaxFlow::addEdge(size_t from, size_t to, double capacity,
+    double reverseCapacity) {
+  if (from >= mNumNodes)
+    throw OutOfBoundException<size_t>(from,
+      "MaxFlow::addEdge(): node out of range", __FILE__, __LINE__);
+  if (to >= mNumNodes)
+    throw OutOfBoundException<size_t>(to,
+      "MaxFlow::addEdge(): node out of range", __FILE__, __LINE__);
+  if (capacity <= 0 && reverseCapacity <= 0)
+    return;
+  Edge edge;
+  edge.mTo = to;
+  edge.mCapacity = capacity;
+  mEdges.push_back(edge);
+  edge.mTo = from;
+  edge.mCapacity = reverseCapacity;
+  mEdges.push_back(edge);
+}
+
+void MaxFlow::sortEdges() {
+  mFirstEdges.assign(mNumNodes + 1, 0);
+  for (size_t e = 0; e < mEdges.size(); ++e)
+    mFirstEdges[mEdges[e ^ 1].mTo + 1]++;
+  for (size_t i = 0; i < mNumNodes; ++i)
+    mFirstEdges[i + 1] += mFirstEdges[i];
+  std::vector<size_t> positions(mFirstEdges.begin(), mFirstEdges.end() - 1);
+  mSortedEdges.resize(mEdges.size());
+  for (size_t e = 0; e < mEdges.size(); ++e)
+    mSortedEdges[positions[mEdges[e ^ 1].mTo]++] = e;
+}
+
+void MaxFlow::setActive(size_t node) {
+  if (!mNodes[node].mActive) {
+    mNodes[node].mActive = true;
+    mActiveNodes.push_back(node);
+  }
+}
+
+size_t MaxFlow::getNextActive() {
+  while (!mActiveNodes.empty()) {
+    const size_t node = mActiveNodes.front();
+    mActiveNodes.pop_front();
+    mNodes[node].mActive = false;
+    if (mNodes[node].mParent != noParent)
+      return node;
+  }
+  return noParent;
+}
+
+double MaxFlow::compute() {
+  sortEdges();
+  for (size_t i = 0; i < mNumNodes; ++i) {
+    Node& node = mNodes[i];
+    node.mTimestamp = 0;
+    if (node.mTerminalCapacity != 0) {
+      node.mSinkTree = node.mTerminalCapacity < 0;
+      node.mParent = terminalParent;
+      node.mDistance = 1;
+      setActive(i);
+    }
+    else
+      node.mParent = noParent;
+  }
+  size_t current = noParent;
+  while (true) {
+    size_t i = current;
+    if (i == noParent || mNodes[i].mParent == noParent) {
+      i = getNextActive();
+      if (i == noParent)
+        break;
+    }
+    const bool sinkTree = mNodes[i].mSinkTree;
+    size_t middle = noParent;
+    for (size_t k = mFirstEdges[i]; k < mFirstEdges[i + 1]; ++k) {
+      const size_t a = mSortedEdges[k];
+      if (!((sinkTree ? mEdges[a ^ 1] : mEdges[a]).mCapacity > 0))
+        continue;
+      const size_t j = mEdges[a].mTo;
+      Node& node = mNodes[j];
+      if (node.mParent == noParent) {
+        node.mSinkTree = sinkTree;
+        node.mParent = a ^ 1;
+        node.mTimestamp = mNodes[i].mTimestamp;
+        node.mDistance = mNodes[i].mDistance + 1;
+        setActive(j);
+      }
+      else if (node.mSinkTree != sinkTree) {
+        middle = sinkTree ? a ^ 1 : a;
+        break;
+      }
+      else if (node.mTimestamp <= mNodes[i].mTimestamp &&
+          node.mDistance > mNodes[i].mDistance) {
+        node.mParent = a ^ 1;
+        node.mTimestamp = mNodes[i].mTimestamp;
+        node.mDistance = mNodes[i].mDistance + 1;
+      }
+    }
+    mTime++;
+    if (middle != noParent) {
+      current = i;
+      augment(middle);
+      while (!mOrphans.empty()) {
+        const size_t orphan = mOrphans.front();
+        mOrphans.pop_front();
+        adoptOrphan(orphan);
+      }
+    }
+    else
+      current = noParent;
+  }
+  return mFlow;
+}
+
+void MaxFlow::augment(size_t middle) {
+  double bottleneck = mEdges[middle].mCapacity;
+  size_t i = mEdges[middle ^ 1].mTo;
+  while (mNodes[i].mParent != terminalParent) {
+    const size_t a = mNodes[i].mParent;
+    bottleneck = std::min(bottleneck, mEdges[a ^ 1].mCapacity);
+    i = mEdges[a].mTo;
+  }
+  bottleneck = std::min(bottleneck, mNodes[i].mTerminalCapacity);
+  i = mEdges[middle].mTo;
+  while (mNodes[i].mParent != terminalParent) {
+    const size_t a = mNodes[i].mParent;
+    bottleneck = std::min(bottleneck, mEdges[a].mCapacity);
+    i = mEdges[a].mTo;
+  }
+  bottleneck = std::min(bottleneck, -mNodes[i].mTerminalCapacity);
+  mEdges[middle ^ 1].mCapacity += bottleneck;
+  mEdges[middle].mCapacity -= bottleneck;
+  for (i = mEdges[middle ^ 1].mTo; ; ) {
+    const size_t a = mNodes[i].mParent;
+    if (a == terminalParent) {
+      mNodes[i].mTerminalCapacity -= bottleneck;
+      if (mNodes[i].mTerminalCapacity == 0) {
+        mNodes[i].mParent = orphanParent;
+        mOrphans.push_front(i);
+      }
+      break;
+    }
+    mEdges[a].mCapacity += bottleneck;
+    mEdges[a ^ 1].mCapacity -= bottleneck;
+    if (mEdges[a ^ 1].mCapacity == 0) {
+      mNodes[i].mParent = orphanParent;
+      mOrphans.push_front(i);
+    }
+    i = mEdges[a].mTo;
+  }
+  for (i = mEdges[middle].mTo; ; ) {
+    const size_t a = mNodes[i].mParent;
+    if (a == terminalParent) {
+      mNodes[i].mTerminalCapacity += bottleneck;
+      if (mNodes[i].mTerminalCapacity == 0) {
+        mNodes[i].mParent = orphanParent;
+        mOrphans.push_front(i);
+      }
+      break;
+    }
+    mEdges[a ^ 1].mCapacity += bottleneck;
+    mEdges[a].mCapacity -= bottleneck;
+    if (mEdges[a].mCapacity == 0) {
+      mNodes[i].mParent = orphanParent;
+      mOrphans.push_front(i);
+    }
+    i = mEdges[a].mTo;
+  }
+  mFlow += bottleneck;
+}
+
+void MaxFlow::adoptOrphan(size_t i) {
+  const bool sinkTree = mNodes[i].mSinkTree;
+  const size_t infinity = (size_t)-1;
+  size_t bestEdge = noParent;
+  size_t bestDistance = infinity;
+  for (size_t k = mFirstEdges[i]; k < mFirstEdges[i + 1]; ++k) {
+    const size_t a0 = mSortedEdges[k];
+    if (!((sinkTree ? mEdges[a0] : mEdges[a0 ^ 1]).mCapacity > 0))
+      continue;
+    size_t j = mEdges[a0].mTo;
+    if (mNodes[j].mSinkTree != sinkTree || mNodes[j].mParent == noParent)
+      continue;
+    size_t distance = 0;
+    while (true) {
+      if (mNodes[j].mTimestamp == mTime) {
+        distance += mNodes[j].mDistance;
+        break;
+      }
+      const size_t a = mNodes[j].mParent;
+      distance++;
+      if (a == terminalParent) {
+        mNodes[j].mTimestamp = mTime;
+        mNodes[j].mDistance = 1;
+        break;
+      }
+      if (a == orphanParent) {
+        distance = infinity;
+        break;
+      }
+      j = mEdges[a].mTo;
+    }
+    if (distance == infinity)
+      continue;
+    if (distance < bestDistance) {
+      bestEdge = a0;
+      bestDistance = distance;
+    }
+    for (j = mEdges[a0].mTo; mNodes[j].mTimestamp != mTime;
+        j = mEdges[mNodes[j].mParent].mTo) {
+      mNodes[j].mTimestamp = mTime;
+      mNodes[j].mDistance = distance--;
+    }
+  }
+  mNodes[i].mParent = bestEdge;
+  if (bestEdge != noParent) {
+    mNodes[i].mTimestamp = mTime;
+    mNodes[i].mDistance = bestDistance + 1;
+    return;
+  }
+  for (size_t k = mFirstEdges[i]; k < mFirstEdges[i + 1]; ++k) {
+    const size_t a0 = mSortedEdges[k];
+    const size_t j = mEdges[a0].mTo;
+    const size_t a = mNodes[j].mParent;
+    if (mNodes[j].mSinkTree != sinkTree || a == noParent)
+      continue;
+    if ((sinkTree ? mEdges[a0] : mEdges[a0 ^ 1]).mCapacity > 0)
+      setActive(j);
+    if (a != terminalParent && a != orphanParent && mEdges[a].mTo == i) {
+      mNodes[j].mParent = orphanParent;
+      mOrphans.push_back(j);
+    }
+  }
+}
@@ -0,0 +1,167 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file MaxFlow.h
+    \brief This file defines the MaxFlow class, which computes maximum flows
+           and minimum s-t cuts on directed graphs.
+  */
+
+#ifndef MAXFLOW_H
+#define MAXFLOW_H
+
+#include <cstddef>
+#include <vector>
+#include <deque>
+
+/** The class MaxFlow computes the maximum flow between a source and a sink
+    terminal with the augmenting paths algorithm of Boykov and Kolmogorov,
+    which grows and reuses search trees from both terminals and is fast on
+    grid graphs. Nodes are connected to the terminals with t-links and to
+    each other with pairs of directed edges. After the computation, the
+    minimum cut separates the nodes of the source search tree from the
+    others.
+    \brief Maximum flow and minimum cut
+  */
+class MaxFlow {
+  /** \name Private constructors
+    @{
+    */
+  /// Copy constructor
+  MaxFlow(const MaxFlow& other);
+  /// Assignment operator
+  MaxFlow& operator = (const MaxFlow& other);
+  /** @}
+    */
+
+public:
+  /** \name Constructors/destructor
+    @{
+    */
+  /// Constructs graph with a number of nodes and no edges
+  MaxFlow(size_t numNodes = 0);
+  /// Destructor
+  virtual ~MaxFlow();
+  /** @}
+    */
+
+  /** \name Accessors
+    @{
+    */
+  /// Returns the number of nodes, terminals excluded
+  size_t getNumNodes() const;
+  /// Returns the flow of the last computation
+  double getFlow() const;
+  /// Returns true if a node is on the source side of the minimum cut
+  bool isSourceSide(size_t node) const;
+  /** @}
+    */
+
+  /** \name Methods
+    @{
+    */
+  /// Removes all the edges and sets the number of nodes
+  void reset(size_t numNodes);
+  /// Adds capacities from the source and to the sink for a node
+  void addTerminalEdges(size_t node, double sourceCapacity,
+    double sinkCapacity);
+  /// Adds an edge and its reverse edge between two nodes
+  void addEdge(size_t from, size_t to, double capacity,
+    double reverseCapacity = 0.0);
+  /// Computes the maximum flow / Returns the flow
+  double compute();
+  /** @}
+    */
+
+protected:
+  /** \name Protected types
+    @{
+    */
+  /// Directed edge with residual capacity, paired with its reverse edge
+  struct Edge {
+    /// Head node of the edge
+    size_t mTo;
+    /// Residual capacity of the edge
+    double mCapacity;
+  };
+  /// Node of the search trees
+  struct Node {
+    /// Edge to the parent in the tree, or one of the special values
+    size_t mParent;
+    /// Time at which the distance to the terminal was computed
+    size_t mTimestamp;
+    /// Distance to the terminal
+    size_t mDistance;
+    /// Residual capacity from the source (> 0) or to the sink (< 0)
+    double mTerminalCapacity;
+    /// True if the node belongs to the sink tree
+    bool mSinkTree;
+    /// True if the node is in the active queue
+    bool mActive;
+  };
+  /** @}
+    */
+
+  /** \name Protected methods
+    @{
+    */
+  /// Sorts the edges by tail node
+  void sortEdges();
+  /// Adds a node to the active queue
+  void setActive(size_t node);
+  /// Returns the next active node of the trees or noParent if none
+  size_t getNextActive();
+  /// Augments the flow along the path through the middle edge
+  void augment(size_t middle);
+  /// Finds a new parent for an orphan or frees it
+  void adoptOrphan(size_t node);
+  /** @}
+    */
+
+  /** \name Protected members
+    @{
+    */
+  /// Parent value of free nodes
+  static const size_t noParent = (size_t)-1;
+  /// Parent value of nodes connected to their terminal
+  static const size_t terminalParent = (size_t)-2;
+  /// Parent value of orphan nodes
+  static const size_t orphanParent = (size_t)-3;
+  /// Number of nodes, terminals excluded
+  size_t mNumNodes;
+  /// Nodes
+  std::vector<Node> mNodes;
+  /// Edges, reverse edges have indices differing by the last bit
+  std::vector<Edge> mEdges;
+  /// Edges sorted by tail node
+  std::vector<size_t> mSortedEdges;
+  /// Index of the first outgoing edge of the nodes in the sorted edges
+  std::vector<size_t> mFirstEdges;
+  /// Active nodes queue
+  std::deque<size_t> mActiveNodes;
+  /// Orphan nodes queue
+  std::deque<size_t> mOrphans;
+  /// Time of the algorithm
+  size_t mTime;
+  /// Flow
+  double mFlow;
+  /** @}
+    */
+
+};
+
+#endif // MAXFLOW_H
@@ -0,0 +1,195 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include "ml/PottsGrid.h"
+
+#include <cmath>
+#include <limits>
+
+#include "exceptions/BadArgumentException.h"
+#include "exceptions/OutOfBoundException.h"
+
+/******************************************************************************/
+/* Constructors and Destructor                                                */
+/******************************************************************************/
+
+PottsGrid::PottsGrid(size_t numRows, size_t numCols, size_t numLabels,
+    double strength) :
+    mNumRows(0),
+    mNumCols(0),
+    mNumLabels(0),
+    mStrength(strength) {
+  PottsGrid::resize(numRows, numCols, numLabels);
+}
+
+PottsGrid::PottsGrid(const PottsGrid& other) :
+    mNumRows(other.mNumRows),
+    mNumCols(other.mNumCols),
+    mNumLabels(other.mNumLabels),
+    mVertices(other.mVertices),
+    mNodePotentials(other.mNodePotentials),
+    mStrength(other.mStrength) {
+}
+
+PottsGrid& PottsGrid::operator = (const PottsGrid& other) {
+  if (this != &other) {
+    mNumRows = other.mNumRows;
+    mNumCols = other.mNumCols;
+    mNumLabels = other.mNumLabels;
+    mVertices = other.mVertices;
+    mNodePotentials = other.mNodePotentials;
+    mStrength = other.mStrength;
+  }
+  return *this;
+}
+
+PottsGrid::~PottsGrid() {
+}
+
+/******************************************************************************/
+/* Accessors                                                                  */
+/******************************************************************************/
+
+size_t PottsGrid::getNumRows() const {
+  return mNumRows;
+}
+
+size_t PottsGrid::getNumCols() const {
+  return mNumCols;
+}
+
+size_t PottsGrid::getNumLabels() const {
+  return mNumLabels;
+}
+
+size_t PottsGrid::getNumCells() const {
+  return mNumRows * mNumCols;
+}
+
+size_t PottsGrid::getCell(size_t row, size_t col) const {
+  if (row >= mNumRows)
+    throw OutOfBoundException<size_t>(row,
+      "PottsGrid::getCell(): row out of range", __FILE__, __LINE__);
+  if (col >= mNumCols)
+    throw OutOfBoundException<size_t>(col,
+      "PottsGrid::getCell(): column out of range", __FILE__, __LINE__);
+  return row * mNumCols + col;
+}
+
+void PottsGrid::setVertex(size_t row, size_t col, bool vertex) {
+  mVertices[getCell(row, col)] = vertex;
+}
+
+bool PottsGrid::isVertex(size_t row, size_t col) const {
+  return mVertices[getCell(row, col)];
+}
+
+PottsGrid::Potentials& PottsGrid::getNodePotentials() {
+  return mNodePotentials;
+}
+
+const PottsGrid::Potentials& PottsGrid::getNodePotentials() const {
+  return mNodePotentials;
+}
+
+double PottsGrid::getStrength() const {
+  return mStrength;
+}
+
+void PottsGrid::setStrength(double strength) {
+  mStrength = strength;
+}
+
+double PottsGrid::getEnergy() const {
+  std::vector<size_t> labels(getNumCells(), 0);
+  for (size_t cell = 0; cell < labels.size(); ++cell)
+    if (mVertices[cell])
+      labels[cell] = getLabel(cell);
+  return computeEnergy(labels);
+}
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+void PottsGrid::resize(size_t numRows, size_t numCols, size_t numLabels) {
+  if (numLabels == 0)
+    throw BadArgumentException<size_t>(numLabels,
+      "PottsGrid::resize(): number of labels must be strictly positive",
+      __FILE__, __LINE__);
+  mNumRows = numRows;
+  mNumCols = numCols;
+  mNumLabels = numLabels;
+  const size_t numCells = getNumCells();
+  mVertices.assign(numCells, false);
+  if (numCells)
+    mNodePotentials = Potentials::Constant(numLabels, numCells, 1.0);
+}
+
+bool PottsGrid::getNeighbour(size_t cell, Direction direction,
+    size_t& neighbour) const {
+  const size_t row = cell / mNumCols;
+  const size_t col = cell % mNumCols;
+  switch (direction) {
+    case left:
+      if (col == 0)
+        return false;
+      neighbour = cell - 1;
+      break;
+    case right:
+      if (col + 1 == mNumCols)
+        return false;
+      neighbour = cell + 1;
+      break;
+    case up:
+      if (row == 0)
+        return false;
+      neighbour = cell - mNumCols;
+      break;
+    case down:
+      if (row + 1 == mNumRows)
+        return false;
+      neighbour = cell + mNumCols;
+      break;
+    default:
+      return false;
+  }
+  return mVertices[neighbour];
+}
+
+double PottsGrid::getCost(size_t label, size_t cell) const {
+  return -log(std::max(mNodePotentials(label, cell),
+    std::numeric_limits<double>::min()));
+}
+
+double PottsGrid::computeEnergy(const std::vector<size_t>& labels) const {
+  double energy = 0;
+  for (size_t cell = 0; cell < labels.size(); ++cell) {
+    if (!mVertices[cell])
+      continue;
+    energy += getCost(labels[cell], cell);
+    size_t neighbour;
+    if (getNeighbour(cell, right, neighbour) &&
+        labels[neighbour] != labels[cell])
+      energy += mStrength;
+    if (getNeighbour(cell, down, neighbour) &&
+        labels[neighbour] != labels[cell])
+      energy += mStrength;
+  }
+  return energy;
+}
@@ -0,0 +1,151 @@
+/******************************************************************************
+ * Copyright (C) 2011 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file PottsGrid.h
+    \brief This file defines the PottsGrid class, which is the base class of
+           the labelers of 4-connected grids with Potts pairwise factors.
+  */
+
+#ifndef POTTSGRID_H
+#define POTTSGRID_H
+
+#include <vector>
+
+#include <Eigen/Core>
+
+/** The class PottsGrid holds a Markov random field on a 4-connected grid of
+    cells, with node potentials and Potts pairwise factors exp(strength) on
+    the diagonal and 1 elsewhere. Only the cells flagged as vertices are part
+    of the graph. Derived classes implement the labeling.
+    \brief Base class for labelers of Potts grids
+  */
+class PottsGrid {
+public:
+  /** \name Types definitions
+    @{
+    */
+  /// Neighbour directions, opposite directions differ by the last bit
+  enum Direction {
+    /// Neighbour on the previous column
+    left = 0,
+    /// Neighbour on the next column
+    right = 1,
+    /// Neighbour on the previous row
+    up = 2,
+    /// Neighbour on the next row
+    down = 3,
+    /// Number of directions
+    numDirections = 4
+  };
+  /// Potentials type, one column per cell
+  typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> Potentials;
+  /** @}
+    */
+
+  /** \name Constructors/destructor
+    @{
+    */
+  /// Constructs grid with all cells disabled
+  PottsGrid(size_t numRows = 0, size_t numCols = 0, size_t numLabels = 1,
+    double strength = 10.0);
+  /// Copy constructor
+  PottsGrid(const PottsGrid& other);
+  /// Assignment operator
+  PottsGrid& operator = (const PottsGrid& other);
+  /// Destructor
+  virtual ~PottsGrid();
+  /** @}
+    */
+
+  /** \name Accessors
+    @{
+    */
+  /// Returns the number of rows of the grid
+  size_t getNumRows() const;
+  /// Returns the number of columns of the grid
+  size_t getNumCols() const;
+  /// Returns the number of labels
+  size_t getNumLabels() const;
+  /// Returns the number of cells of the grid
+  size_t getNumCells() const;
+  /// Returns the cell index of a grid position
+  size_t getCell(size_t row, size_t col) const;
+  /// Enables or disables a cell as a vertex of the graph
+  void setVertex(size_t row, size_t col, bool vertex = true);
+  /// Returns true if a cell is a vertex of the graph
+  bool isVertex(size_t row, size_t col) const;
+  /// Returns the node potentials for modification (linear domain)
+  Potentials& getNodePotentials();
+  /// Returns the node potentials (linear domain)
+  const Potentials& getNodePotentials() const;
+  /// Returns the Potts strength
+  double getStrength() const;
+  /// Sets the Potts strength
+  void setStrength(double strength);
+  /// Returns the label of a cell
+  virtual size_t getLabel(size_t cell) const = 0;
+  /// Returns the energy of the labeling (-log-probability up to a constant)
+  double getEnergy() const;
+  /** @}
+    */
+
+  /** \name Methods
+    @{
+    */
+  /// Resizes the grid and disables all cells
+  virtual void resize(size_t numRows, size_t numCols, size_t numLabels);
+  /// Computes the labeling / Returns the number of iterations
+  virtual size_t run() = 0;
+  /// Returns the energy of a labeling of the cells
+  double computeEnergy(const std::vector<size_t>& labels) const;
+  /** @}
+    */
+
+protected:
+  /** \name Protected methods
+    @{
+    */
+  /// Returns the neighbour of a cell in a direction / false if none
+  bool getNeighbour(size_t cell, Direction direction, size_t& neighbour)
+    const;
+  /// Returns the unary cost of a label for a cell
+  double getCost(size_t label, size_t cell) const;
+  /** @}
+    */
+
+  /** \name Protected members
+    @{
+    */
+  /// Number of rows
+  size_t mNumRows;
+  /// Number of columns
+  size_t mNumCols;
+  /// Number of labels
+  size_t mNumLabels;
+  /// Vertex flags of the cells
+  std::vector<bool> mVertices;
+  /// Node potentials in the linear domain
+  Potentials mNodePotentials;
+  /// Potts strength
+  double mStrength;
+  /** @}
+    */
+
+};
+
+#endif // POTTSGRID_H
@@ -18,10 +18,16 @@
 
 #include "processing/Processor.h"
 
+#include <memory>
+
+#include "base/ScopedTimer.h"
 #include "helpers/InitML.h"
 #include "helpers/FGTools.h"
 #include "data-structures/PropertySet.h"
 #include "ml/BeliefPropagation.h"
+#include "ml/GridBeliefPropagation.h"
+#include "ml/GridAlphaExpansion.h"
+#include "ml/GridTRWS.h"
 #include "data-structures/FactorGraph.h"
 #include "data-structures/Component.h"
 #include "statistics/EstimatorML.h"
@@ -35,7 +41,10 @@ Processor::Processor(const Grid<double, Cell, 2>::Coordinate& minDEM,
     const Grid<double, Cell, 2>::Coordinate& maxDEM,
     const Grid<double, Cell, 2>::Coordinate& demCellSize, double k,
     size_t maxMLIter, double mlTol, bool weighted, size_t maxBPIter,
-    double bpTol, bool logDomain) :
+    double bpTol, bool logDomain, size_t numThreads, bool acceleratedML,
+    double mlMinWeight, double mlMergeTol, bool singlePrecision,
+    Inference inference, size_t bpNumLevels, bool residualBP,
+    double bpTimeBudget, double bpStrength) :
     mMinDEM(minDEM),
     mMaxDEM(maxDEM),
     mDEMCellSize(demCellSize),
@@ -46,8 +55,21 @@ Processor::Processor(const Grid<double, Cell, 2>::Coordinate& minDEM,
     mMaxBPIter(maxBPIter),
     mBPTol(bpTol),
     mLogDomain(logDomain),
+    mNumThreads(numThreads),
+    mAcceleratedML(acceleratedML),
+    mMLMinWeight(mlMinWeight),
+    mMLMergeTol(mlMergeTol),
+    mSinglePrecision(singlePrecision),
+    mInference(inference),
+    mBPNumLevels(bpNumLevels),
+    mResidualBP(residualBP),
+    mBPTimeBudget(bpTimeBudget),
+    mBPStrength(bpStrength),
     mDEM(mMinDEM, mMaxDEM, mDEMCellSize),
     mGraph(mDEM),
+    mDEMTime(0.0),
+    mInitMixture(0),
+    mMixture(0),
     mValid(false) {
 }
 
@@ -62,9 +84,27 @@ Processor::Processor(const Processor& other) :
     mMaxBPIter(other.mMaxBPIter),
     mBPTol(other.mBPTol),
     mLogDomain(other.mLogDomain),
+    mNumThreads(other.mNumThreads),
+    mAcceleratedML(other.mAcceleratedML),
+    mMLMinWeight(other.mMLMinWeight),
+    mMLMergeTol(other.mMLMergeTol),
+    mSinglePrecision(other.mSinglePrecision),
+    mInference(other.mInference),
+    mBPNumLevels(other.mBPNumLevels),
+    mResidualBP(other.mResidualBP),
+    mBPTimeBudget(other.mBPTimeBudget),
+    mBPStrength(other.mBPStrength),
     mDEM(other.mDEM),
     mGraph(other.mGraph),
     mVerticesLabels(other.mVerticesLabels),
+    mDEMTime(other.mDEMTime),
+    mPoints(other.mPoints),
+    mInitMixture(other.mInitMixture ?
+      new MixtureDistribution<LinearRegression<3>, Eigen::Dynamic>(
+      *other.mInitMixture) : 0),
+    mMixture(other.mMixture ?
+      new MixtureDistribution<LinearRegression<3>, Eigen::Dynamic>(
+      *other.mMixture) : 0),
     mValid(other.mValid) {
 }
 
@@ -80,15 +120,41 @@ Processor& Processor::operator = (const Processor& other) {
     mMaxBPIter = other.mMaxBPIter;
     mBPTol = other.mBPTol;
     mLogDomain = other.mLogDomain;
+    mNumThreads = other.mNumThreads;
+    mAcceleratedML = other.mAcceleratedML;
+    mMLMinWeight = other.mMLMinWeight;
+    mMLMergeTol = other.mMLMergeTol;
+    mSinglePrecision = other.mSinglePrecision;
+    mInference = other.mInference;
+    mBPNumLevels = other.mBPNumLevels;
+    mResidualBP = other.mResidualBP;
+    mBPTimeBudget = other.mBPTimeBudget;
+    mBPStrength = other.mBPStrength;
     mDEM = other.mDEM;
     mGraph = other.mGraph;
     mVerticesLabels = other.mVerticesLabels;
+    mDEMTime = other.mDEMTime;
+    mPoints = other.mPoints;
+    if (mInitMixture)
+      delete mInitMixture;
+    mInitMixture = other.mInitMixture ?
+      new MixtureDistribution<LinearRegression<3>, Eigen::Dynamic>(
+      *other.mInitMixture) : 0;
+    if (mMixture)
+      delete mMixture;
+    mMixture = other.mMixture ?
+      new MixtureDistribution<LinearRegression<3>, Eigen::Dynamic>(
+      *other.mMixture) : 0;
     mValid = other.mValid;
   }
   return *this;
 }
 
 Processor::~Processor() {
+  if (mInitMixture)
+    delete mInitMixture;
+  if (mMixture)
+    delete mMixture;
 }
 
 /******************************************************************************/
@@ -192,6 +258,86 @@ void Processor::setLogDomainFlag(bool logDomain) {
   mLogDomain = logDomain;
 }
 
+bool Processor::getAcceleratedMLFlag() const {
+  return mAcceleratedML;
+}
+
+void Processor::setAcceleratedMLFlag(bool acceleratedML) {
+  mAcceleratedML = acceleratedML;
+}
+
+double Processor::getMLMinWeight() const {
+  return mMLMinWeight;
+}
+
+void Processor::setMLMinWeight(double mlMinWeight) {
+  mMLMinWeight = mlMinWeight;
+}
+
+double Processor::getMLMergeTol() const {
+  return mMLMergeTol;
+}
+
+void Processor::setMLMergeTol(double mlMergeTol) {
+  mMLMergeTol = mlMergeTol;
+}
+
+bool Processor::getSinglePrecisionFlag() const {
+  return mSinglePrecision;
+}
+
+void Processor::setSinglePrecisionFlag(bool singlePrecision) {
+  mSinglePrecision = singlePrecision;
+}
+
+Processor::Inference Processor::getInference() const {
+  return mInference;
+}
+
+void Processor::setInference(Inference inference) {
+  mInference = inference;
+}
+
+size_t Processor::getBPNumLevels() const {
+  return mBPNumLevels;
+}
+
+void Processor::setBPNumLevels(size_t bpNumLevels) {
+  mBPNumLevels = bpNumLevels;
+}
+
+bool Processor::getResidualBP() const {
+  return mResidualBP;
+}
+
+void Processor::setResidualBP(bool residualBP) {
+  mResidualBP = residualBP;
+}
+
+double Processor::getBPTimeBudget() const {
+  return mBPTimeBudget;
+}
+
+void Processor::setBPTimeBudget(double bpTimeBudget) {
+  mBPTimeBudget = bpTimeBudget;
+}
+
+double Processor::getBPStrength() const {
+  return mBPStrength;
+}
+
+void Processor::setBPStrength(double bpStrength) {
+  mBPStrength = bpStrength;
+}
+
+size_t Processor::getNumThreads() const {
+  return mNumThreads;
+}
+
+void Processor::setNumThreads(size_t numThreads) {
+  mNumThreads = numThreads;
+}
+
 const Grid<double, Cell, 2>& Processor::getDEM() const {
   return mDEM;
 }
@@ -212,87 +358,213 @@ bool Processor::getValid() const {
 /* Methods                                                                    */
 /******************************************************************************/
 
-void Processor::processPointCloud(const PointCloud<double, 3>& pointCloud) {
+template <typename X>
+void Processor::buildDEM(const PointCloud<X, 3>& pointCloud) {
   mDEM.reset();
   mValid = false;
-  double before = Timestamp::now();
   for (auto it = pointCloud.getPointBegin(); it != pointCloud.getPointEnd();
       ++it) {
-    const Eigen::Matrix<double, 2, 1> point = (*it).segment(0, 2);
+    const Eigen::Matrix<double, 2, 1> point =
+      (*it).segment(0, 2).template cast<double>();
     if (mDEM.isInRange(point))
       mDEM(point).addPoint((*it)(2));
   }
-  double after = Timestamp::now();
-  std::cout << "DEM creation: " << after - before << std::endl;
-  const double demTime = after - before;
-  before = Timestamp::now();
+}
+
+template <typename S>
+bool Processor::estimateMixture(const MixtureDistribution<LinearRegression<3>,
+    Eigen::Dynamic>& initMixture, const std::vector<Eigen::Matrix<double, 3, 1>
+    >& points, MixtureDistribution<LinearRegression<3>, Eigen::Dynamic>&
+    mixture) const {
+  EstimatorML<MixtureDistribution<LinearRegression<3>, Eigen::Dynamic>, S>
+    estMixtPlane(initMixture, mMaxMLIter, mMLTol, mNumThreads);
+  estMixtPlane.setAccelerated(mAcceleratedML);
+  estMixtPlane.setMinWeight(mMLMinWeight);
+  estMixtPlane.setMergeTolerance(mMLMergeTol);
+  const size_t numIter = estMixtPlane.addPointsEM(points.begin(),
+    points.end());
+  std::cout << "Mixture ML steps: " << numIter << " (extrapolations: "
+    << estMixtPlane.getNumExtrapolations() << ", rejections: "
+    << estMixtPlane.getNumRejections() << ")" << std::endl;
+  mixture = estMixtPlane.getMixtureDist();
+  return estMixtPlane.getValid();
+}
+
+bool Processor::labelVertices(const MixtureDistribution<LinearRegression<3>,
+    Eigen::Dynamic>& mixture) {
+  mVerticesLabels.clear();
+  if (mInference != libDAIBP) {
+    std::unique_ptr<PottsGrid> labeler;
+    GridTRWS* trwsLabeler = 0;
+    GridBeliefPropagation* bpLabeler = 0;
+    if (mInference == gridBP) {
+      labeler.reset(bpLabeler = new GridBeliefPropagation(0, 0, 1,
+        mBPStrength, mMaxBPIter, mBPTol, GridBeliefPropagation::maxProduct,
+        mLogDomain, mResidualBP ? GridBeliefPropagation::residual :
+        mNumThreads == 1 ? GridBeliefPropagation::sequential :
+        GridBeliefPropagation::checkerboard, mNumThreads));
+      bpLabeler->setNumLevels(mBPNumLevels);
+      bpLabeler->setTimeBudget(mBPTimeBudget);
+    }
+    else if (mInference == trws)
+      labeler.reset(trwsLabeler = new GridTRWS(0, 0, 1, mBPStrength,
+        mMaxBPIter, mBPTol));
+    else
+      labeler.reset(new GridAlphaExpansion());
+    Helpers::buildPottsGrid(mDEM, mGraph, mixture, *labeler, mBPStrength);
+    const size_t numIter = labeler->run();
+    std::cout << (mInference == alphaExpansion ? "Expansion cycles: " :
+      mInference == trws ? "TRW-S iterations: " : "BP iterations: ")
+      << numIter << " (energy: " << labeler->getEnergy();
+    if (trwsLabeler)
+      std::cout << ", lower bound: " << trwsLabeler->getLowerBound();
+    std::cout << ")" << std::endl;
+    if (bpLabeler && numIter > 0) {
+      const std::vector<GridBeliefPropagation::IterationStats>& stats =
+        bpLabeler->getIterationStats();
+      size_t numUpdates = 0;
+      for (size_t i = 0; i < stats.size(); ++i)
+        numUpdates += stats[i].mNumUpdates;
+      std::cout << "BP messages: " << numUpdates << " (last residual: "
+        << stats.back().mMaxResidual << ", time: " << stats.back().mTime
+        << ")" << std::endl;
+    }
+    for (auto it = mGraph.getVertexBegin(); it != mGraph.getVertexEnd(); ++it)
+      mVerticesLabels[it->first] = labeler->getLabel(labeler->getCell(
+        it->first(0), it->first(1)));
+    return true;
+  }
+  FactorGraph factorGraph;
+  DEMGraph::VertexContainer fgMapping;
+  Helpers::buildFactorGraph(mDEM, mGraph, mixture, factorGraph, fgMapping,
+    mBPStrength);
+  PropertySet opts;
+  opts.set("maxiter", mMaxBPIter);
+  opts.set("tol", mBPTol);
+  opts.set("verbose", (size_t)0);
+  opts.set("updates", std::string("SEQRND"));
+  opts.set("logdomain", mLogDomain);
+  opts.set("inference", std::string("MAXPROD"));
+  BeliefPropagation bp(factorGraph, opts);
+  bp.init();
+  try {
+    bp.run();
+  }
+  catch (dai::Exception& e) {
+    return false;
+  }
+  std::vector<size_t> mapState;
+  mapState.reserve(factorGraph.nrVars());
+  mapState = bp.findMaximum();
+  GridAlphaExpansion pottsGrid;
+  Helpers::buildPottsGrid(mDEM, mGraph, mixture, pottsGrid, mBPStrength);
+  std::vector<size_t> labels(pottsGrid.getNumCells(), 0);
+  for (auto it = mGraph.getVertexBegin(); it != mGraph.getVertexEnd();
+      ++it) {
+    mVerticesLabels[it->first] = mapState[fgMapping[it->first]];
+    labels[pottsGrid.getCell(it->first(0), it->first(1))] =
+      mVerticesLabels[it->first];
+  }
+  std::cout << "BP iterations: " << bp.Iterations() << " (energy: "
+    << pottsGrid.computeEnergy(labels) << ")" << std::endl;
+  return true;
+}
+
+void Processor::buildDEM(const PointCloud<double, 3>& pointCloud) {
+  ScopedTimer timer("Processor::buildDEM()");
+  buildDEM<double>(pointCloud);
+  mDEMTime = timer.stop();
+  std::cout << "DEM creation: " << mDEMTime << std::endl;
+}
+
+void Processor::buildDEM(const PointCloud<float, 3>& pointCloud) {
+  ScopedTimer timer("Processor::buildDEM()");
+  buildDEM<float>(pointCloud);
+  mDEMTime = timer.stop();
+  std::cout << "DEM creation: " << mDEMTime << std::endl;
+}
+
+bool Processor::segmentDEM() {
+  mValid = false;
+  if (mInitMixture)
+    delete mInitMixture;
+  mInitMixture = 0;
+  if (mMixture)
+    delete mMixture;
+  mMixture = 0;
+  mPoints.clear();
+  mArena.reset();
+  ScopedTimer graphTimer("Processor::segmentDEM()::graph");
   mGraph = DEMGraph(mDEM);
-  after = Timestamp::now();
-  std::cout << "Graph creation: " << after - before << std::endl;
-  const double graphTime = after - before;
-  before = Timestamp::now();
-  GraphSegmenter<DEMGraph>::Components components;
+  const double graphTime = graphTimer.stop();
+  std::cout << "Graph creation: " << graphTime << std::endl;
+  ScopedTimer segTimer("Processor::segmentDEM()::segmentation");
+  GraphSegmenter<DEMGraph>::Components components(0, std::hash<size_t>(),
+    std::equal_to<size_t>(),
+    GraphSegmenter<DEMGraph>::ComponentsAllocator(&mArena));
   GraphSegmenter<DEMGraph>::segment(mGraph, components, mGraph.getVertices(),
     mK);
-  after = Timestamp::now();
-  std::cout << "Graph segmentation: " << after - before << std::endl;
-  const double segTime = after - before;
-  std::cout << "Init time: " << demTime + graphTime + segTime << std::endl;
-  before = Timestamp::now();
-  EstimatorML<LinearRegression<3> >::Container points;
+  const double segTime = segTimer.stop();
+  std::cout << "Graph segmentation: " << segTime << std::endl;
+  std::cout << "Init time: " << mDEMTime + graphTime + segTime << std::endl;
+  ScopedTimer initTimer("Processor::segmentDEM()::initML");
   std::vector<DEMGraph::VertexDescriptor> pointsMapping;
-  MixtureDistribution<LinearRegression<3>, Eigen::Dynamic>* initMixture = 0;
-  if (Helpers::initML(mDEM, mGraph, components, points, pointsMapping,
-      initMixture, mWeighted)) {
-    after = Timestamp::now();
-    std::cout << "Initial ML: " << after - before << std::endl;
-    if (initMixture->getCompDistributions().size() > 1) {
-      before = Timestamp::now();
-      EstimatorML<MixtureDistribution<LinearRegression<3>, Eigen::Dynamic> >
-        estMixtPlane(*initMixture, mMaxMLIter, mMLTol);
-      const size_t numIter = estMixtPlane.addPointsEM(points.begin(),
-        points.end());
-      after = Timestamp::now();
-      std::cout << "Mixture ML: " << after - before << std::endl;
-      if (estMixtPlane.getValid()) {
-        FactorGraph factorGraph;
-        DEMGraph::VertexContainer fgMapping;
-        Helpers::buildFactorGraph(mDEM, mGraph, estMixtPlane.getMixtureDist(),
-          factorGraph, fgMapping);
-        PropertySet opts;
-        opts.set("maxiter", mMaxBPIter);
-        opts.set("tol", mBPTol);
-        opts.set("verbose", (size_t)0);
-        opts.set("updates", std::string("SEQRND"));
-        opts.set("logdomain", mLogDomain);
-        opts.set("inference", std::string("MAXPROD"));
-        BeliefPropagation bp(factorGraph, opts);
-        bp.init();
-        try {
-          bp.run();
-        }
-        catch (dai::Exception& e) {
-          std::cout << estMixtPlane.getMixtureDist() << std::endl;
-          return;
-        }
-        std::vector<size_t> mapState;
-        mapState.reserve(factorGraph.nrVars());
-        mapState = bp.findMaximum();
-        mVerticesLabels.clear();
-        for (auto it = mGraph.getVertexBegin(); it != mGraph.getVertexEnd();
-            ++it)
-          mVerticesLabels[it->first] = mapState[fgMapping[it->first]];
-        mValid = true;
-      }
-    }
-    else {
-      mVerticesLabels.clear();
-      for (auto it = mGraph.getVertexBegin(); it != mGraph.getVertexEnd();
-          ++it)
-        mVerticesLabels[it->first] = 0;
-      mValid = true;
-    }
+  if (!Helpers::initML(mDEM, mGraph, components, mPoints, pointsMapping,
+      mInitMixture, mWeighted, mNumThreads))
+    return false;
+  std::cout << "Initial ML: " << initTimer.stop() << std::endl;
+  return true;
+}
+
+bool Processor::estimateMixture() {
+  mValid = false;
+  if (mMixture)
+    delete mMixture;
+  mMixture = 0;
+  if (!mInitMixture)
+    return false;
+  mMixture = new MixtureDistribution<LinearRegression<3>, Eigen::Dynamic>(
+    *mInitMixture);
+  if (mInitMixture->getCompDistributions().size() == 1)
+    return true;
+  ScopedTimer timer("Processor::estimateMixture()");
+  const bool valid = mSinglePrecision ?
+    estimateMixture<float>(*mInitMixture, mPoints, *mMixture) :
+    estimateMixture<double>(*mInitMixture, mPoints, *mMixture);
+  std::cout << "Mixture ML: " << timer.stop() << std::endl;
+  return valid;
+}
+
+bool Processor::labelVertices() {
+  mValid = false;
+  if (!mMixture)
+    return false;
+  if (mMixture->getCompDistributions().size() == 1) {
+    mVerticesLabels.clear();
+    for (auto it = mGraph.getVertexBegin(); it != mGraph.getVertexEnd(); ++it)
+      mVerticesLabels[it->first] = 0;
+    mValid = true;
+    return mValid;
   }
-  if (initMixture)
-    delete initMixture;
+  ScopedTimer timer("Processor::labelVertices()");
+  mValid = labelVertices(*mMixture);
+  std::cout << "Labeling: " << timer.stop() << std::endl;
+  if (!mValid)
+    std::cout << *mMixture << std::endl;
+  return mValid;
+}
+
+void Processor::processPointCloud(const PointCloud<double, 3>& pointCloud) {
+  buildDEM(pointCloud);
+  processDEM();
+}
+
+void Processor::processPointCloud(const PointCloud<float, 3>& pointCloud) {
+  buildDEM(pointCloud);
+  processDEM();
+}
+
+void Processor::processDEM() {
+  if (segmentDEM() && estimateMixture())
+    labelVertices();
 }
@@ -25,11 +25,13 @@
 #define PROCESSOR_H
 
 #include "base/Serializable.h"
+#include "base/Arena.h"
 #include "data-structures/Grid.h"
 #include "data-structures/Cell.h"
 #include "data-structures/PointCloud.h"
 #include "data-structures/DEMGraph.h"
 #include "statistics/MixtureDistribution.h"
+#include "statistics/LinearRegression.h"
 
 /** The class Processor performs all the computations to detect planes, curbs,
     and sidewalks from a 3D point cloud input.
@@ -38,6 +40,23 @@
 class Processor :
   public virtual Serializable {
 public:
+  /** \name Types definitions
+    @{
+    */
+  /// Inference engines for the final labeling
+  enum Inference {
+    /// libDAI max-product BP on the factor graph
+    libDAIBP,
+    /// In-tree max-product BP on the DEM grid
+    gridBP,
+    /// In-tree graph-cut alpha-expansion on the DEM grid
+    alphaExpansion,
+    /// In-tree sequential tree-reweighted message passing on the DEM grid
+    trws
+  };
+  /** @}
+    */
+
   /** \name Constructors/destructor
     @{
     */
@@ -49,7 +68,12 @@ public:
     const Grid<double, Cell, 2>::Coordinate& demCellSize =
     Grid<double, Cell, 2>::Coordinate(0.1, 0.1), double k = 300.0,
     size_t maxMLIter = 200, double mlTol = 1e-6, bool weighted = false,
-    size_t maxBPIter = 200, double bpTol = 1e-6, bool logDomain = false);
+    size_t maxBPIter = 200, double bpTol = 1e-6, bool logDomain = false,
+    size_t numThreads = 1, bool acceleratedML = false,
+    double mlMinWeight = 0.0, double mlMergeTol = 0.0,
+    bool singlePrecision = false, Inference inference = libDAIBP,
+    size_t bpNumLevels = 1, bool residualBP = false,
+    double bpTimeBudget = 0.0, double bpStrength = 10.0);
   /// Copy constructor
   Processor(const Processor& other);
   /// Assignment operator
@@ -102,6 +126,46 @@ public:
   bool getLogDomainFlag() const;
   /// Sets the log-domain inference flag
   void setLogDomainFlag(bool logDomain);
+  /// Returns the accelerated ML flag
+  bool getAcceleratedMLFlag() const;
+  /// Sets the accelerated ML flag
+  void setAcceleratedMLFlag(bool acceleratedML);
+  /// Returns the ML minimum component weight
+  double getMLMinWeight() const;
+  /// Sets the ML minimum component weight
+  void setMLMinWeight(double mlMinWeight);
+  /// Returns the ML merge tolerance on plane coefficients
+  double getMLMergeTol() const;
+  /// Sets the ML merge tolerance on plane coefficients
+  void setMLMergeTol(double mlMergeTol);
+  /// Returns the single-precision ML flag
+  bool getSinglePrecisionFlag() const;
+  /// Sets the single-precision ML flag
+  void setSinglePrecisionFlag(bool singlePrecision);
+  /// Returns the inference engine for the labeling
+  Inference getInference() const;
+  /// Sets the inference engine for the labeling
+  void setInference(Inference inference);
+  /// Returns the number of coarse-to-fine BP levels
+  size_t getBPNumLevels() const;
+  /// Sets the number of coarse-to-fine BP levels
+  void setBPNumLevels(size_t bpNumLevels);
+  /// Returns the residual BP schedule flag
+  bool getResidualBP() const;
+  /// Sets the residual BP schedule flag
+  void setResidualBP(bool residualBP);
+  /// Returns the BP time budget in seconds (0 means unlimited)
+  double getBPTimeBudget() const;
+  /// Sets the BP time budget in seconds (0 means unlimited)
+  void setBPTimeBudget(double bpTimeBudget);
+  /// Returns the strength of the Potts smoothness prior
+  double getBPStrength() const;
+  /// Sets the strength of the Potts smoothness prior
+  void setBPStrength(double bpStrength);
+  /// Returns the number of threads
+  size_t getNumThreads() const;
+  /// Sets the number of threads (0 means one per CPU)
+  void setNumThreads(size_t numThreads);
   /// Returns the DEM
   const Grid<double, Cell, 2>& getDEM() const;
   /// Returns the DEM graph
@@ -118,10 +182,40 @@ public:
     */
   /// Process a point cloud
   void processPointCloud(const PointCloud<double, 3>& pointCloud);
+  /// Process a single-precision point cloud
+  void processPointCloud(const PointCloud<float, 3>& pointCloud);
+  /// Builds the DEM from a point cloud (first stage)
+  void buildDEM(const PointCloud<double, 3>& pointCloud);
+  /// Builds the DEM from a single-precision point cloud (first stage)
+  void buildDEM(const PointCloud<float, 3>& pointCloud);
+  /// Segments the DEM and fits the initial mixture (second stage)
+  bool segmentDEM();
+  /// Estimates the mixture from the initial one (third stage)
+  bool estimateMixture();
+  /// Labels the DEM vertices from the mixture (last stage)
+  bool labelVertices();
   /** @}
     */
 
 protected:
+  /** \name Protected methods
+    @{
+    */
+  /// Builds the DEM from a point cloud
+  template <typename X> void buildDEM(const PointCloud<X, 3>& pointCloud);
+  /// Process the DEM once built
+  void processDEM();
+  /// Labels the DEM vertices from the mixture / Returns validity
+  bool labelVertices(const MixtureDistribution<LinearRegression<3>,
+    Eigen::Dynamic>& mixture);
+  /// Estimates the mixture with working precision S / Returns validity
+  template <typename S> bool estimateMixture(const
+    MixtureDistribution<LinearRegression<3>, Eigen::Dynamic>& initMixture,
+    const std::vector<Eigen::Matrix<double, 3, 1> >& points,
+    MixtureDistribution<LinearRegression<3>, Eigen::Dynamic>& mixture) const;
+  /** @}
+    */
+
   /** \name Stream methods
     @{
     */
@@ -159,6 +253,26 @@ protected:
   double mBPTol;
   /// Log-domain inference
   bool mLogDomain;
+  /// Number of threads
+  size_t mNumThreads;
+  /// Accelerated ML
+  bool mAcceleratedML;
+  /// ML minimum component weight
+  double mMLMinWeight;
+  /// ML merge tolerance
+  double mMLMergeTol;
+  /// Single-precision ML
+  bool mSinglePrecision;
+  /// Inference engine for the labeling
+  Inference mInference;
+  /// Number of coarse-to-fine BP levels
+  size_t mBPNumLevels;
+  /// Residual BP schedule
+  bool mResidualBP;
+  /// BP time budget in seconds
+  double mBPTimeBudget;
+  /// Potts smoothness prior strength
+  double mBPStrength;
 
   /// DEM
   Grid<double, Cell, 2> mDEM;
@@ -166,6 +280,16 @@ protected:
   DEMGraph mGraph;
   /// Vertices labels
   DEMGraph::VertexContainer mVerticesLabels;
+  /// Time spent building the DEM
+  double mDEMTime;
+  /// Points of the segmented DEM for the mixture estimation
+  std::vector<Eigen::Matrix<double, 3, 1> > mPoints;
+  /// Initial mixture from the segmentation
+  MixtureDistribution<LinearRegression<3>, Eigen::Dynamic>* mInitMixture;
+  /// Estimated mixture
+  MixtureDistribution<LinearRegression<3>, Eigen::Dynamic>* mMixture;
+  /// Arena of the segmentation temporaries, reset for each scan
+  Arena mArena;
 
   /// One point cloud has been processed and we have valid results
   bool mValid;
@@ -27,11 +27,13 @@
 #include <unordered_map>
 
 #include "data-structures/Component.h"
+#include "base/ArenaAllocator.h"
 #include "exceptions/BadArgumentException.h"
 
 /** The class GraphSegmenter implements the graph-based segmentation algorithm
     described in [Felzenszwalb, 2004]. The input graph must be an undirected
-    graph.
+    graph. The temporaries of a segmentation are drawn from the arena of the
+    components allocator, if any.
     \brief Graph-based segmentation algorithm
   */
 template <typename G> class GraphSegmenter {
@@ -47,14 +49,20 @@ public:
   typedef typename G::EdgeDescriptor E;
   /// Constant edge iterator
   typedef typename G::ConstEdgeIterator CstItE;
+  /// Component type
+  typedef Component<V, double, ArenaAllocator<V> > ComponentType;
   /// Component vertex iterator
-  typedef typename Component<V, double>::ConstVertexIterator CstItCV;
+  typedef typename ComponentType::ConstVertexIterator CstItCV;
   /// Vertices type
   typedef typename G::VertexContainer Vertices;
   /// Constant vertex iterator
   typedef typename G::ConstVertexIterator CstItV;
+  /// Components allocator
+  typedef ArenaAllocator<std::pair<const size_t, ComponentType> >
+    ComponentsAllocator;
   /// Components type
-  typedef std::unordered_map<size_t, Component<V, double> > Components;
+  typedef std::unordered_map<size_t, ComponentType, std::hash<size_t>,
+    std::equal_to<size_t>, ComponentsAllocator> Components;
   /// Components constant iterator
   typedef typename Components::const_iterator CstItComp;
   /** @}
@@ -82,18 +90,10 @@ private:
     @{
     */
   /// Threshold function
-  static double getTau(const Component<V, double>& c);
+  static double getTau(const ComponentType& c, double k);
   /// Returns the minimum internal difference between two components
-  static double getMInt(const Component<V, double>& c1, const
-    Component<V, double>& c2);
-  /** @}
-    */
-
-  /** \name Private members
-    @{
-    */
-  /// Parameter for the algorithm
-  static double mK;
+  static double getMInt(const ComponentType& c1, const ComponentType& c2,
+    double k);
   /** @}
     */
 
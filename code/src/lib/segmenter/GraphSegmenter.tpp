@@ -19,22 +19,20 @@
 #include <algorithm>
 #include <map>
 
-template <typename G>
-double GraphSegmenter<G>::mK = 100.0;
-
 /******************************************************************************/
 /* Methods                                                                    */
 /******************************************************************************/
 
 template <typename G>
-double GraphSegmenter<G>::getTau(const Component<V, double>& c) {
-  return mK / c.getNumVertices();
+double GraphSegmenter<G>::getTau(const ComponentType& c, double k) {
+  return k / c.getNumVertices();
 }
 
 template <typename G>
-double GraphSegmenter<G>::getMInt(const Component<V, double>& c1, const
-    Component<V, double>& c2) {
-  return std::min(c1.getProperty() + getTau(c1), c2.getProperty() + getTau(c2));
+double GraphSegmenter<G>::getMInt(const ComponentType& c1,
+    const ComponentType& c2, double k) {
+  return std::min(c1.getProperty() + getTau(c1, k),
+    c2.getProperty() + getTau(c2, k));
 }
 
 template <typename G>
@@ -43,22 +41,27 @@ void GraphSegmenter<G>::segment(G& graph, Components& components,
   if (k < 0)
     throw BadArgumentException<double>(k,
       "GraphSegmenter<G>::segment(): k must be positive", __FILE__, __LINE__);
-  std::multimap<double, E> edges;
+  const ArenaAllocator<V> allocator(components.get_allocator());
+  std::multimap<double, E, std::less<double>,
+    ArenaAllocator<std::pair<const double, E> > > edges(std::less<double>(),
+    allocator);
   for (auto it = graph.getEdgeBegin(); it != graph.getEdgeEnd(); ++it) {
     const E e = graph.getEdge(it);
     edges.insert(std::pair<double, E>(graph.getEdgeProperty(e), e));
   }
   components.clear();
+  components.rehash(vertices.size());
   for (auto it = vertices.begin(); it != vertices.end(); ++it)
-    components[it->second] = Component<V, double>(it->first);
-  mK = k;
+    components.insert(std::make_pair(it->second,
+      ComponentType(it->first, 0.0, allocator)));
   for (auto it = edges.begin(); it != edges.end(); ++it) {
     const E& e = it->second;
     const V& v1 = graph.getHeadVertex(e);
     const size_t c1  = vertices[v1];
     const V& v2 = graph.getTailVertex(e);
     const size_t c2 = vertices[v2];
-    if (c1 != c2 && it->first <= getMInt(components[c1], components[c2])) {
+    if (c1 != c2 && it->first <= getMInt(components[c1], components[c2],
+        k)) {
       for (auto itC = components[c2].getVertexBegin();
           itC != components[c2].getVertexEnd(); ++itC)
         vertices[*itC] = c1;
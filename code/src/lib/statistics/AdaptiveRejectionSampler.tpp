@@ -62,7 +62,7 @@ void getSamples(const Function<Y, X>& logpdf, const Function<Y, X>& logpdfprime,
       "invalid starting points");
   samples.clear();
   samples.reserve(numSamples);
-  const static Randomizer<double> randomizer;
+  const Randomizer<double>& randomizer = Randomizer<double>::getLocal();
   while (samples.size() != numSamples) {
     std::sort(points.begin(), points.end(), TupleCompare());
     std::vector<X> z;
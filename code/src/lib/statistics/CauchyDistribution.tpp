@@ -101,7 +101,7 @@ double CauchyDistribution::cdf(const RandomVariable& value) const {
 }
 
 CauchyDistribution::RandomVariable CauchyDistribution::getSample() const {
-  const static Randomizer<double> randomizer;
+  const Randomizer<double>& randomizer = Randomizer<double>::getLocal();
   return mLocation + mScale * tan(M_PI * (randomizer.sampleUniform() - 0.5));
 }
 
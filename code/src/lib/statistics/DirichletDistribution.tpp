@@ -189,7 +189,7 @@ double DirichletDistribution<M>::logpdf(const typename
 template <size_t M>
 typename DirichletDistribution<M>::RandomVariable
     DirichletDistribution<M>::getSample() const {
-  const static Randomizer<double> randomizer;
+  const Randomizer<double>& randomizer = Randomizer<double>::getLocal();
   RandomVariable sampleGammaVector(mAlpha.size());
   for (size_t i = 0; i < (size_t)mAlpha.size(); ++i)
     sampleGammaVector(i) = randomizer.sampleGamma(mAlpha(i), 1.0);
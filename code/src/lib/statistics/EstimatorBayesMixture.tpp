@@ -116,7 +116,7 @@ void EstimatorBayes<MixtureDistribution<C, M>,
   Eigen::Matrix<double, M, 1> numPointsComp =
     Eigen::Matrix<double, M, 1>::Zero(K);
   typename DirichletDistribution<M>::RandomVariable p = mDirPrior.getSample();
-  const static Randomizer<double, M> randomizer;
+  const Randomizer<double, M>& randomizer = Randomizer<double, M>::getLocal();
   for (auto it = itStart; it != itEnd; ++it) {
     const size_t row = it - itStart;
     mAssignments(row) = randomizer.sampleCategorical(p);
@@ -178,7 +178,8 @@ void EstimatorBayes<MixtureDistribution<C, M>,
   components.push_back(mCompPrior.getSample());
   std::vector<C> compDist;
   compDist.push_back(C(components[0]));
-  const static Randomizer<double, Eigen::Dynamic> randomizer;
+  const Randomizer<double, Eigen::Dynamic>& randomizer =
+    Randomizer<double, Eigen::Dynamic>::getLocal();
   const LogSumExpFunction<double, Eigen::Dynamic> lse;
   size_t K = 1;
   double alpha = 1.0 / randomizer.sampleGamma(1.0, 1.0);
@@ -26,7 +26,7 @@
 
 #include <cstdlib>
 
-template <typename D> class EstimatorML;
+template <typename D, typename S = double> class EstimatorML;
 
 //#include "statistics/EstimatorMLNormal1v.h"
 //#include "statistics/EstimatorMLNormalMv.h"
@@ -32,6 +32,8 @@
 #include "data-structures/Cell.h"
 #include "data-structures/DEMGraph.h"
 #include "data-structures/FactorGraph.h"
+#include "ml/GridBeliefPropagation.h"
+#include "helpers/FGTools.h"
 
 template <typename D> class EstimatorMLBP;
 
@@ -61,7 +63,8 @@ public:
   EstimatorMLBP(const MixtureDistribution<LinearRegression<N>, M>& initDist,
     const Grid<double, Cell, 2>& dem, const DEMGraph& graph,
     std::vector<DEMGraph::VertexDescriptor>& pointsMapping,
-    size_t maxNumIter = 200, double tol = 1e-6);
+    size_t maxNumIter = 200, double tol = 1e-6, bool nativeBP = false,
+    size_t numThreads = 1);
   /// Copy constructor
   EstimatorMLBP(const EstimatorMLBP& other);
   /// Assignment operator
@@ -84,6 +87,8 @@ public:
   const Eigen::Matrix<double, Eigen::Dynamic, M>& getResponsibilities() const;
   /// Returns the vertices labels
   DEMGraph::VertexContainer getVerticesLabels();
+  /// Returns the number of BP iterations of the last EM run
+  size_t getNumBPIterations() const;
   /// Returns the log-likelihood of the data
   double getLogLikelihood() const;
   /// Returns the tolerance of the estimator
@@ -94,6 +99,18 @@ public:
   size_t getMaxNumIter() const;
   /// Sets the maximum number of iterations for EM
   void setMaxNumIter(size_t maxNumIter);
+  /// Returns true if the in-tree grid BP is used instead of libDAI
+  bool getNativeBP() const;
+  /// Sets the use of the in-tree grid BP instead of libDAI
+  void setNativeBP(bool nativeBP);
+  /// Returns the number of coarse-to-fine levels of the grid BP
+  size_t getNumLevels() const;
+  /// Sets the number of coarse-to-fine levels of the grid BP
+  void setNumLevels(size_t numLevels);
+  /// Returns the number of threads of the grid BP
+  size_t getNumThreads() const;
+  /// Sets the number of threads of the grid BP (0 means one per CPU)
+  void setNumThreads(size_t numThreads);
   /// Add points to the estimator / Returns number of EM iterationss
   size_t addPointsEM(const ConstPointIterator& itStart, const
     ConstPointIterator& itEnd);
@@ -117,6 +134,14 @@ protected:
   /** @}
     */
 
+  /** \name Protected methods
+    @{
+    */
+  /// Returns the thread pool of the grid BP, created on first use
+  ThreadPool& getThreadPool();
+  /** @}
+    */
+
   /** \name Protected members
     @{
     */
@@ -132,6 +157,12 @@ protected:
   FactorGraph mFactorGraph;
   /// Factor graph mapping
   DEMGraph::VertexContainer mFgMapping;
+  /// Grid BP
+  GridBeliefPropagation mGridBP;
+  /// Node potentials of the vertices
+  Helpers::NodePotentialsTask mNodePotentials;
+  /// Preallocated node factors of the factor graph
+  std::vector<dai::Factor> mNodeFactors;
   /// Estimated responsibilities
   Eigen::Matrix<double, Eigen::Dynamic, M> mResponsibilities;
   /// Log-likelihood of the data
@@ -142,8 +173,14 @@ protected:
   double mTol;
   /// Number of points in the estimator
   size_t mNumPoints;
+  /// Number of BP iterations of the last EM run
+  size_t mNumBPIter;
   /// Valid flag
   bool mValid;
+  /// Grid BP flag
+  bool mNativeBP;
+  /// Thread pool of the grid BP, kept across runs
+  ThreadPool* mThreadPool;
   /** @}
     */
 
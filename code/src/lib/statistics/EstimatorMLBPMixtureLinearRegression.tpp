@@ -32,16 +32,24 @@ EstimatorMLBP<MixtureDistribution<LinearRegression<N>, M> >::EstimatorMLBP(const
     MixtureDistribution<LinearRegression<N>, M>& initDist, const
     Grid<double, Cell, 2>& dem, const DEMGraph& graph,
     std::vector<DEMGraph::VertexDescriptor>& pointsMapping, size_t maxNumIter,
-    double tol) :
+    double tol, bool nativeBP, size_t numThreads) :
     mMixtureDist(initDist),
     mDEM(dem),
     mGraph(graph),
     mPointsMapping(pointsMapping),
+    mNodePotentials(dem, graph, numThreads),
     mLogLikelihood(0),
     mMaxNumIter(maxNumIter),
     mTol(tol),
     mNumPoints(0),
-    mValid(false) {
+    mNumBPIter(0),
+    mValid(false),
+    mNativeBP(nativeBP),
+    mThreadPool(0) {
+  setNumThreads(numThreads);
+  if (mNativeBP)
+    Helpers::buildPottsGrid(mDEM, mGraph, mMixtureDist, mGridBP);
+  else
     Helpers::buildFactorGraph(mDEM, mGraph, mMixtureDist, mFactorGraph,
       mFgMapping);
 }
@@ -55,12 +63,18 @@ EstimatorMLBP<MixtureDistribution<LinearRegression<N>, M> >::
     mPointsMapping(other.mPointsMapping),
     mFactorGraph(other.mFactorGraph),
     mFgMapping(other.mFgMapping),
+    mGridBP(other.mGridBP),
+    mNodePotentials(other.mNodePotentials),
+    mNodeFactors(other.mNodeFactors),
     mResponsibilities(other.mResponsibilities),
     mLogLikelihood(other.mLogLikelihood),
     mMaxNumIter(other.mMaxNumIter),
     mTol(other.mTol),
     mNumPoints(other.mNumPoints),
-    mValid(other.mValid) {
+    mNumBPIter(other.mNumBPIter),
+    mValid(other.mValid),
+    mNativeBP(other.mNativeBP),
+    mThreadPool(0) {
 }
 
 template <size_t N, size_t M>
@@ -74,18 +88,26 @@ EstimatorMLBP<MixtureDistribution<LinearRegression<N>, M> >&
     mPointsMapping = other.mPointsMapping;
     mFactorGraph = other.mFactorGraph;
     mFgMapping = other.mFgMapping;
+    mGridBP = other.mGridBP;
+    mNodePotentials = other.mNodePotentials;
+    mNodeFactors = other.mNodeFactors;
     mResponsibilities = other.mResponsibilities;
     mLogLikelihood = other.mLogLikelihood;
     mMaxNumIter = other.mMaxNumIter;
     mTol = other.mTol;
     mNumPoints = other.mNumPoints;
+    mNumBPIter = other.mNumBPIter;
     mValid = other.mValid;
+    mNativeBP = other.mNativeBP;
+    delete mThreadPool;
+    mThreadPool = 0;
   }
   return *this;
 }
 
 template <size_t N, size_t M>
 EstimatorMLBP<MixtureDistribution<LinearRegression<N>, M> >::~EstimatorMLBP() {
+  delete mThreadPool;
 }
 
 /******************************************************************************/
@@ -105,7 +127,8 @@ void EstimatorMLBP<MixtureDistribution<LinearRegression<N>, M> >::
     << "maxNumIter: " << mMaxNumIter << std::endl
     << "tolerance: " << mTol << std::endl
     << "number of points: " << mNumPoints << std::endl
-    << "valid: " << mValid;
+    << "valid: " << mValid << std::endl
+    << "native BP: " << mNativeBP;
 }
 
 template <size_t N, size_t M>
@@ -148,6 +171,12 @@ bool EstimatorMLBP<MixtureDistribution<LinearRegression<N>, M> >::getValid()
   return mValid;
 }
 
+template <size_t N, size_t M>
+size_t EstimatorMLBP<MixtureDistribution<LinearRegression<N>, M> >::
+    getNumBPIterations() const {
+  return mNumBPIter;
+}
+
 template <size_t N, size_t M>
 double EstimatorMLBP<MixtureDistribution<LinearRegression<N>, M> >::
     getLogLikelihood() const {
@@ -178,10 +207,68 @@ void EstimatorMLBP<MixtureDistribution<LinearRegression<N>, M> >::
   mMaxNumIter = maxNumIter;
 }
 
+template <size_t N, size_t M>
+bool EstimatorMLBP<MixtureDistribution<LinearRegression<N>, M> >::
+    getNativeBP() const {
+  return mNativeBP;
+}
+
+template <size_t N, size_t M>
+void EstimatorMLBP<MixtureDistribution<LinearRegression<N>, M> >::
+    setNativeBP(bool nativeBP) {
+  if (nativeBP == mNativeBP)
+    return;
+  mNativeBP = nativeBP;
+  if (mNativeBP)
+    Helpers::buildPottsGrid(mDEM, mGraph, mMixtureDist, mGridBP);
+  else
+    Helpers::buildFactorGraph(mDEM, mGraph, mMixtureDist, mFactorGraph,
+      mFgMapping);
+}
+
+template <size_t N, size_t M>
+size_t EstimatorMLBP<MixtureDistribution<LinearRegression<N>, M> >::
+    getNumLevels() const {
+  return mGridBP.getNumLevels();
+}
+
+template <size_t N, size_t M>
+void EstimatorMLBP<MixtureDistribution<LinearRegression<N>, M> >::
+    setNumLevels(size_t numLevels) {
+  mGridBP.setNumLevels(numLevels);
+}
+
+template <size_t N, size_t M>
+size_t EstimatorMLBP<MixtureDistribution<LinearRegression<N>, M> >::
+    getNumThreads() const {
+  return mGridBP.getNumThreads();
+}
+
+template <size_t N, size_t M>
+void EstimatorMLBP<MixtureDistribution<LinearRegression<N>, M> >::
+    setNumThreads(size_t numThreads) {
+  delete mThreadPool;
+  mThreadPool = 0;
+  mGridBP.setNumThreads(numThreads);
+  mNodePotentials.setNumThreads(numThreads);
+  mGridBP.setSchedule(numThreads == 1 ? GridBeliefPropagation::sequential :
+    GridBeliefPropagation::checkerboard);
+}
+
+template <size_t N, size_t M>
+ThreadPool& EstimatorMLBP<MixtureDistribution<LinearRegression<N>, M> >::
+    getThreadPool() {
+  if (!mThreadPool)
+    mThreadPool = new ThreadPool(mGridBP.getSchedule() ==
+      GridBeliefPropagation::checkerboard ? mGridBP.getNumThreads() : 1);
+  return *mThreadPool;
+}
+
 template <size_t N, size_t M>
 void EstimatorMLBP<MixtureDistribution<LinearRegression<N>, M> >::reset() {
   mLogLikelihood = 0;
   mNumPoints = 0;
+  mNumBPIter = 0;
   mValid = false;
 }
 
@@ -204,31 +291,51 @@ size_t EstimatorMLBP<MixtureDistribution<LinearRegression<N>, M> >::
   opts.set("updates", std::string("SEQRND"));
   opts.set("logdomain", false);
   opts.set("inference", std::string("SUMPROD"));
+  BeliefPropagation bp;
+  if (mNativeBP) {
+    mGridBP.setInference(GridBeliefPropagation::sumProduct);
+    mGridBP.init();
+  }
+  else {
+    bp = BeliefPropagation(mFactorGraph, opts);
+    bp.init();
+  }
   while (numIter != mMaxNumIter) {
     mValid = true;
-    BeliefPropagation bp(mFactorGraph, opts);
-    bp.init();
-    try {
-      bp.run();
-    }
-    catch (dai::Exception& e) {
-      std::cout << e.what() << std::endl;
-      mValid = false;
-      break;
+    double logLikelihood;
+    if (mNativeBP) {
+      mNumBPIter += mGridBP.run(getThreadPool());
+      const GridBeliefPropagation::Potentials& beliefs = mGridBP.getBeliefs();
+      for (size_t row = 0; row < mNumPoints; ++row) {
+        const DEMGraph::VertexDescriptor& index = mPointsMapping[row];
+        const size_t cell = mGridBP.getCell(index(0), index(1));
+        for (size_t j = 0 ; j < K; ++j)
+          mResponsibilities(row, j) = beliefs(j, cell);
+      }
+      logLikelihood = mGridBP.getLogZ();
     }
-    std::vector<dai::Factor> factors;
-    factors.reserve(mFactorGraph.nrVars());
-    for (size_t i = 0; i < mFactorGraph.nrVars(); ++i)
-      factors.push_back(bp.beliefV(i));
-    Eigen::Matrix<double, M, 1> numPoints =
-      Eigen::Matrix<double, M, 1>::Zero(K);
-    for (auto it = itStart; it != itEnd; ++it) {
-      const size_t row = it - itStart;
-      for (size_t j = 0 ; j < K; ++j)
-        mResponsibilities(row, j) = factors[mFgMapping[mPointsMapping[row]]][j];
-      numPoints += mResponsibilities.row(row).transpose();
+    else {
+      try {
+        bp.run();
+      }
+      catch (dai::Exception& e) {
+        std::cout << e.what() << std::endl;
+        mValid = false;
+        break;
+      }
+      mNumBPIter += bp.Iterations();
+      std::vector<dai::Factor> factors;
+      factors.reserve(mFactorGraph.nrVars());
+      for (size_t i = 0; i < mFactorGraph.nrVars(); ++i)
+        factors.push_back(bp.beliefV(i));
+      for (size_t row = 0; row < mNumPoints; ++row)
+        for (size_t j = 0 ; j < K; ++j)
+          mResponsibilities(row, j) =
+            factors[mFgMapping[mPointsMapping[row]]][j];
+      logLikelihood = bp.logZ();
     }
-    const double logLikelihood = bp.logZ();
+    const Eigen::Matrix<double, M, 1> numPoints =
+      mResponsibilities.colwise().sum().transpose();
     if (fabs(mLogLikelihood - logLikelihood) < mTol)
       break;
     mLogLikelihood = logLikelihood;
@@ -245,10 +352,17 @@ size_t EstimatorMLBP<MixtureDistribution<LinearRegression<N>, M> >::
     catch (...) {
       mValid = false;
     }
-    Helpers::updateNodeFactors(mDEM, mGraph, mMixtureDist, mFactorGraph,
-      mFgMapping);
+    mNodePotentials.update(mMixtureDist);
+    if (mNativeBP)
+      Helpers::updateNodePotentials(mNodePotentials, mGridBP);
+    else
+      Helpers::updateNodeFactors(mNodePotentials, bp, mNodeFactors);
     numIter++;
   }
+  if (!mNativeBP) {
+    mNodePotentials.update(mMixtureDist);
+    Helpers::updateNodeFactors(mNodePotentials, mFactorGraph, mNodeFactors);
+  }
   return numIter;
 }
 
@@ -256,6 +370,15 @@ template <size_t N, size_t M>
 DEMGraph::VertexContainer
     EstimatorMLBP<MixtureDistribution<LinearRegression<N>, M> >::
     getVerticesLabels() {
+  DEMGraph::VertexContainer vertices;
+  if (mNativeBP) {
+    mGridBP.setInference(GridBeliefPropagation::maxProduct);
+    mGridBP.run(getThreadPool());
+    for (auto it = mGraph.getVertexBegin(); it != mGraph.getVertexEnd(); ++it)
+      vertices[it->first] = mGridBP.getLabel(mGridBP.getCell(it->first(0),
+        it->first(1)));
+    return vertices;
+  }
   PropertySet opts;
   opts.set("maxiter", (size_t)200);
   opts.set("tol", 1e-9);
@@ -269,7 +392,6 @@ DEMGraph::VertexContainer
   std::vector<size_t> mapState;
   mapState.reserve(mFactorGraph.nrVars());
   mapState = bp.findMaximum();
-  DEMGraph::VertexContainer vertices;
   for (auto it = mGraph.getVertexBegin(); it != mGraph.getVertexEnd(); ++it)
     vertices[it->first] = mapState[mFgMapping[it->first]];
   return vertices;
@@ -40,6 +40,8 @@ public:
   typedef std::vector<Point> Container;
   /// Constant point iterator
   typedef typename Container::const_iterator ConstPointIterator;
+  /// Weighted moments of the augmented points [1, x, y]
+  typedef Eigen::Matrix<double, M + 1, M + 1> Moments;
   /** @}
     */
 
@@ -74,6 +76,15 @@ public:
     itEnd, const Eigen::Matrix<double, Eigen::Dynamic, 1>& responsibilities);
   /// Add points to the estimator
   void addPoints(const Container& points);
+  /// Add points to the estimator through their weighted moments
+  void addPoints(const Moments& moments, size_t numPoints);
+  /// Returns the weighted moments of a block of points (one point per row)
+  template <typename P, typename W> static Moments getMoments(const
+    Eigen::MatrixBase<P>& points, const Eigen::MatrixBase<W>& weights);
+  /// Accumulates the weighted moments of a point of any scalar type
+  template <typename Q, typename P> static void addMoments(
+    Eigen::MatrixBase<Q>& moments, const Eigen::MatrixBase<P>& point,
+    double weight);
   /// Reset the estimator
   void reset();
   /** @}
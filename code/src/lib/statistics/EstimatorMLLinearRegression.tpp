@@ -17,6 +17,7 @@
  ******************************************************************************/
 
 #include <Eigen/LU>
+#include <Eigen/Array>
 
 /******************************************************************************/
 /* Constructors and Destructor                                                */
@@ -157,3 +158,59 @@ template <size_t M>
 void  EstimatorML<LinearRegression<M> >::addPoints(const Container& points) {
   addPoints(points.begin(), points.end());
 }
+
+template <size_t M>
+void EstimatorML<LinearRegression<M> >::addPoints(const Moments& moments,
+    size_t numPoints) {
+  reset();
+  mNumPoints = numPoints;
+  if (mNumPoints < M || moments(0, 0) < M)
+    return;
+  try {
+    const Eigen::Matrix<double, M, M> designMoments =
+      moments.block(0, 0, M, M);
+    const Eigen::Matrix<double, M, 1> targetMoments =
+      moments.block(0, M, M, 1);
+    const Eigen::Matrix<double, M, 1> coeffs = designMoments.inverse() *
+      targetMoments;
+    for (size_t i = 0; i < M; ++i)
+      if (std::isnan(coeffs(i)))
+        return;
+    mValid = true;
+    mLinearRegression.setLinearBasisFunction(
+      LinearBasisFunction<double, M>(coeffs));
+    mLinearRegression.setVariance((moments(M, M) - 2.0 *
+      coeffs.dot(targetMoments) + coeffs.dot(designMoments * coeffs)) /
+      moments(0, 0));
+  }
+  catch (...) {
+    mValid = false;
+  }
+}
+
+template <size_t M>
+template <typename P, typename W>
+typename EstimatorML<LinearRegression<M> >::Moments
+    EstimatorML<LinearRegression<M> >::getMoments(const
+    Eigen::MatrixBase<P>& points, const Eigen::MatrixBase<W>& weights) {
+  Moments moments = Moments::Zero();
+  for (size_t i = 0; i < (size_t)points.rows(); ++i)
+    addMoments(moments, points.row(i), weights(i));
+  return moments;
+}
+
+template <size_t M>
+template <typename Q, typename P>
+void EstimatorML<LinearRegression<M> >::addMoments(Eigen::MatrixBase<Q>&
+    moments, const Eigen::MatrixBase<P>& point, double weight) {
+  if (weight == 0.0)
+    return;
+  moments(0, 0) += weight;
+  for (size_t i = 0; i < M; ++i) {
+    const double weightedValue = weight * point(i);
+    moments(0, i + 1) += weightedValue;
+    moments(i + 1, 0) += weightedValue;
+    for (size_t j = 0; j < M; ++j)
+      moments(i + 1, j + 1) += weightedValue * point(j);
+  }
+}
@@ -17,17 +17,23 @@
  ******************************************************************************/
 
 /** \file EstimatorMLMixture.h
-    \brief This file implements a batch ML estimator for mixture distributions.
+    \brief This file implements a batch and online ML estimator for mixture
+           distributions.
   */
 
 #include <vector>
 
 #include "statistics/MixtureDistribution.h"
+#include "statistics/Randomizer.h"
+#include "base/ThreadPool.h"
 
-/** The class EstimatorML is implemented for mixture distributions.
+/** The class EstimatorML is implemented for mixture distributions. The
+    working copies of the points and responsibilities are stored with scalar
+    type S, whereas moments and log-likelihoods are accumulated in double.
     \brief Mixture distributions ML estimator
   */
-template <typename C, size_t M> class EstimatorML<MixtureDistribution<C, M> > :
+template <typename C, size_t M, typename S>
+  class EstimatorML<MixtureDistribution<C, M>, S> :
   public virtual Serializable {
 public:
   /** \name Types definitions
@@ -39,6 +45,11 @@ public:
   typedef std::vector<Point> Container;
   /// Constant point iterator
   typedef typename Container::const_iterator ConstPointIterator;
+  /// Block of points in working precision, one point per row
+  typedef Eigen::Matrix<S, Eigen::Dynamic,
+    C::RandomVariables::ColsAtCompileTime> Points;
+  /// Block of responsibilities in working precision
+  typedef Eigen::Matrix<S, Eigen::Dynamic, M> Responsibilities;
   /** @}
     */
 
@@ -47,7 +58,7 @@ public:
     */
   /// Constructs estimator with initial guess of the parameters
   EstimatorML(const MixtureDistribution<C, M>& initDist, size_t
-    maxNumIter = 200, double tol = 1e-6);
+    maxNumIter = 200, double tol = 1e-6, size_t numThreads = 1);
   /// Copy constructor
   EstimatorML(const EstimatorML& other);
   /// Assignment operator
@@ -78,6 +89,24 @@ public:
   size_t getMaxNumIter() const;
   /// Sets the maximum number of iterations for EM, CEM, SEM
   void setMaxNumIter(size_t maxNumIter);
+  /// Returns the number of threads for EM, CEM, SEM
+  size_t getNumThreads() const;
+  /// Sets the number of threads for EM, CEM, SEM (0 means one per CPU)
+  void setNumThreads(size_t numThreads);
+  /// Returns the number of points per block of parallel processing
+  size_t getBlockSize() const;
+  /// Sets the number of points per block of parallel processing
+  void setBlockSize(size_t blockSize);
+  /// Returns the accelerated EM flag
+  bool getAccelerated() const;
+  /// Sets the accelerated EM flag (SQUAREM extrapolation)
+  void setAccelerated(bool accelerated);
+  /// Returns the number of EM steps performed by the last EM run
+  size_t getNumEMSteps() const;
+  /// Returns the number of accepted extrapolations of the last EM run
+  size_t getNumExtrapolations() const;
+  /// Returns the number of rejected extrapolations of the last EM run
+  size_t getNumRejections() const;
   /// Add points to the estimator / Returns number of EM iterationss
   size_t addPointsEM(const ConstPointIterator& itStart, const
     ConstPointIterator& itEnd);
@@ -89,12 +118,109 @@ public:
   /// Add points to the estimator / Returns number of SEM iterations
   size_t addPointsSEM(const ConstPointIterator& itStart, const
     ConstPointIterator& itEnd);
+  /// Returns the step size decay exponent of online EM
+  double getStepExponent() const;
+  /// Sets the step size decay exponent of online EM
+  void setStepExponent(double stepExponent);
+  /// Returns the randomizer of SEM
+  const Randomizer<double, M>& getRandomizer() const;
+  /// Sets the randomizer of SEM, e.g., for a reproducible seed
+  void setRandomizer(const Randomizer<double, M>& randomizer);
+  /// Returns the minimum weight of a component before it is pruned
+  double getMinWeight() const;
+  /// Sets the minimum weight of a component before it is pruned
+  void setMinWeight(double minWeight);
+  /// Returns the tolerance on plane coefficients for merging components
+  double getMergeTolerance() const;
+  /// Sets the tolerance on plane coefficients for merging components
+  void setMergeTolerance(double mergeTol);
+  /// Returns the number of online EM updates since the last reset
+  size_t getNumUpdates() const;
+  /// Add new points to the estimator with one online EM update
+  void addPointsOnline(const ConstPointIterator& itStart, const
+    ConstPointIterator& itEnd);
   /// Reset the estimator
   void reset();
   /** @}
     */
 
 protected:
+  /** \name Protected types
+    @{
+    */
+  /// Step performed on a block of points
+  enum Step {
+    /// Responsibilities only
+    expectation,
+    /// Responsibilities and moments weighted by the responsibilities
+    expectationMaximization,
+    /// Responsibilities and moments of the most likely assignments
+    classificationMaximization,
+    /// Responsibilities and moments of sampled assignments
+    stochasticMaximization
+  };
+  /// Partial sums over a block of points
+  struct BlockStatistics {
+    /// Log-likelihood of the block
+    double mLogLikelihood;
+    /// Number of points per component
+    Eigen::Matrix<double, Eigen::Dynamic, 1> mNumPoints;
+    /// Moments per component
+    std::vector<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> >
+      mMoments;
+    /// Accumulates the sums of another block
+    BlockStatistics& operator += (const BlockStatistics& other);
+  };
+  /// Task processing the blocks of points in parallel
+  class BlockTask :
+    public ThreadPool::Task {
+  public:
+    /// Constructs task from estimator and step
+    BlockTask(EstimatorML& estimator, Step step);
+    /// Process a block
+    virtual void process(size_t block);
+  protected:
+    /// Estimator
+    EstimatorML& mEstimator;
+    /// Step to perform
+    Step mStep;
+  };
+  /** @}
+    */
+
+  /** \name Protected methods
+    @{
+    */
+  /// Splits the points into blocks
+  void initBlocks(const ConstPointIterator& itStart, const ConstPointIterator&
+    itEnd);
+  /// Process a block of points
+  void processBlock(size_t block, Step step);
+  /// Returns the thread pool, created on first use
+  ThreadPool& getThreadPool();
+  /// Process all the blocks of points
+  void processBlocks(ThreadPool& pool, Step step);
+  /// Returns the reduced statistics of all blocks in a fixed order
+  BlockStatistics reduceBlocks() const;
+  /// Updates the mixture from the statistics
+  void updateMixture(const BlockStatistics& statistics);
+  /// Gathers the responsibilities of all blocks, recomputing them first if
+  /// the mixture was simplified since the last E-step
+  void gatherResponsibilities();
+  /// Prunes and merges components / Returns true if the mixture changed
+  bool simplifyMixture(const BlockStatistics& statistics);
+  /// Performs one EM step / Returns log-likelihood before the step
+  double stepEM(ThreadPool& pool);
+  /// Runs SQUAREM accelerated EM / Returns number of EM steps
+  size_t accelerateEM(ThreadPool& pool);
+  /// Returns the mixture parameters as a vector
+  Eigen::Matrix<double, Eigen::Dynamic, 1> getParameters() const;
+  /// Sets the mixture parameters from a vector / Returns false if invalid
+  bool setParameters(const Eigen::Matrix<double, Eigen::Dynamic, 1>&
+    parameters);
+  /** @}
+    */
+
   /** \name Stream methods
     @{
     */
@@ -126,6 +252,42 @@ protected:
   size_t mNumPoints;
   /// Valid flag
   bool mValid;
+  /// Number of threads
+  size_t mNumThreads;
+  /// Thread pool, kept across calls and rebuilt when mNumThreads changes
+  ThreadPool* mThreadPool;
+  /// Number of points per block
+  size_t mBlockSize;
+  /// Accelerated EM flag
+  bool mAccelerated;
+  /// Number of EM steps of the last run
+  size_t mNumEMSteps;
+  /// Number of accepted extrapolations of the last run
+  size_t mNumExtrapolations;
+  /// Number of rejected extrapolations of the last run
+  size_t mNumRejections;
+  /// Step size decay exponent of online EM
+  double mStepExponent;
+  /// Number of online EM updates
+  size_t mNumUpdates;
+  /// Running sufficient statistics of online EM, normalized per point
+  BlockStatistics mOnlineStatistics;
+  /// Minimum weight of a component
+  double mMinWeight;
+  /// Tolerance on plane coefficients for merging components
+  double mMergeTol;
+  /// Points of each block, one point per row
+  std::vector<Points> mBlockPoints;
+  /// Responsibilities of each block
+  std::vector<Responsibilities> mBlockResponsibilities;
+  /// Hard assignments of each block for CEM and SEM
+  std::vector<std::vector<size_t> > mBlockAssignments;
+  /// Statistics of each block
+  std::vector<BlockStatistics> mBlockStatistics;
+  /// Randomizer of SEM
+  Randomizer<double, M> mRandomizer;
+  /// Non-overlapping randomizer streams of each block for SEM
+  std::vector<Randomizer<double, M> > mBlockRandomizers;
   /** @}
     */
 
@@ -17,39 +17,67 @@
  ******************************************************************************/
 
 #include <limits>
+#include <cmath>
+#include <algorithm>
 
 #include "statistics/Randomizer.h"
-#include "functions/LogSumExpFunction.h"
+#include "exceptions/BadArgumentException.h"
 
 /******************************************************************************/
 /* Constructors and Destructor                                                */
 /******************************************************************************/
 
-template <typename C, size_t M>
-EstimatorML<MixtureDistribution<C, M> >::EstimatorML(const
-    MixtureDistribution<C, M>& initDist, size_t maxNumIter, double tol) :
+template <typename C, size_t M, typename S>
+EstimatorML<MixtureDistribution<C, M>, S>::EstimatorML(const
+    MixtureDistribution<C, M>& initDist, size_t maxNumIter, double tol,
+    size_t numThreads) :
     mMixtureDist(initDist),
     mLogLikelihood(0),
     mMaxNumIter(maxNumIter),
     mTol(tol),
     mNumPoints(0),
-    mValid(false) {
+    mValid(false),
+    mNumThreads(numThreads),
+    mThreadPool(0),
+    mBlockSize(256),
+    mAccelerated(false),
+    mNumEMSteps(0),
+    mNumExtrapolations(0),
+    mNumRejections(0),
+    mStepExponent(0.6),
+    mNumUpdates(0),
+    mMinWeight(0),
+    mMergeTol(0) {
 }
 
-template <typename C, size_t M>
-EstimatorML<MixtureDistribution<C, M> >::EstimatorML(const EstimatorML& other) :
+template <typename C, size_t M, typename S>
+EstimatorML<MixtureDistribution<C, M>, S>::EstimatorML(const EstimatorML&
+    other) :
     mMixtureDist(other.mMixtureDist),
     mResponsibilities(other.mResponsibilities),
     mLogLikelihood(other.mLogLikelihood),
     mMaxNumIter(other.mMaxNumIter),
     mTol(other.mTol),
     mNumPoints(other.mNumPoints),
-    mValid(other.mValid) {
+    mValid(other.mValid),
+    mNumThreads(other.mNumThreads),
+    mThreadPool(0),
+    mBlockSize(other.mBlockSize),
+    mAccelerated(other.mAccelerated),
+    mNumEMSteps(other.mNumEMSteps),
+    mNumExtrapolations(other.mNumExtrapolations),
+    mNumRejections(other.mNumRejections),
+    mStepExponent(other.mStepExponent),
+    mNumUpdates(other.mNumUpdates),
+    mOnlineStatistics(other.mOnlineStatistics),
+    mMinWeight(other.mMinWeight),
+    mMergeTol(other.mMergeTol),
+    mRandomizer(other.mRandomizer) {
 }
 
-template <typename C, size_t M>
-EstimatorML<MixtureDistribution<C, M> >&
-    EstimatorML<MixtureDistribution<C, M> >::operator = (const EstimatorML&
+template <typename C, size_t M, typename S>
+EstimatorML<MixtureDistribution<C, M>, S>&
+    EstimatorML<MixtureDistribution<C, M>, S>::operator = (const EstimatorML&
     other) {
   if (this != &other) {
     mMixtureDist = other.mMixtureDist;
@@ -59,39 +87,68 @@ EstimatorML<MixtureDistribution<C, M> >&
     mTol = other.mTol;
     mNumPoints = other.mNumPoints;
     mValid = other.mValid;
+    setNumThreads(other.mNumThreads);
+    mBlockSize = other.mBlockSize;
+    mAccelerated = other.mAccelerated;
+    mNumEMSteps = other.mNumEMSteps;
+    mNumExtrapolations = other.mNumExtrapolations;
+    mNumRejections = other.mNumRejections;
+    mStepExponent = other.mStepExponent;
+    mNumUpdates = other.mNumUpdates;
+    mOnlineStatistics = other.mOnlineStatistics;
+    mMinWeight = other.mMinWeight;
+    mMergeTol = other.mMergeTol;
+    mRandomizer = other.mRandomizer;
   }
   return *this;
 }
 
-template <typename C, size_t M>
-EstimatorML<MixtureDistribution<C, M> >::~EstimatorML() {
+template <typename C, size_t M, typename S>
+EstimatorML<MixtureDistribution<C, M>, S>::~EstimatorML() {
+  delete mThreadPool;
+}
+
+template <typename C, size_t M, typename S>
+EstimatorML<MixtureDistribution<C, M>, S>::BlockTask::BlockTask(EstimatorML&
+    estimator, Step step) :
+    mEstimator(estimator),
+    mStep(step) {
 }
 
 /******************************************************************************/
 /* Streaming operations                                                       */
 /******************************************************************************/
 
-template <typename C, size_t M>
-void EstimatorML<MixtureDistribution<C, M> >::read(std::istream& stream) {
+template <typename C, size_t M, typename S>
+void EstimatorML<MixtureDistribution<C, M>, S>::read(std::istream& stream) {
 }
 
-template <typename C, size_t M>
-void EstimatorML<MixtureDistribution<C, M> >::write(std::ostream& stream)
+template <typename C, size_t M, typename S>
+void EstimatorML<MixtureDistribution<C, M>, S>::write(std::ostream& stream)
     const {
   stream << "mixture distribution: " << std::endl << mMixtureDist << std::endl
     << "log-likelihood: " << mLogLikelihood << std::endl
     << "maxNumIter: " << mMaxNumIter << std::endl
     << "tolerance: " << mTol << std::endl
     << "number of points: " << mNumPoints << std::endl
+    << "number of threads: " << mNumThreads << std::endl
+    << "accelerated: " << mAccelerated << std::endl
+    << "number of EM steps: " << mNumEMSteps << std::endl
+    << "number of extrapolations: " << mNumExtrapolations << std::endl
+    << "number of rejections: " << mNumRejections << std::endl
+    << "step exponent: " << mStepExponent << std::endl
+    << "number of online updates: " << mNumUpdates << std::endl
+    << "minimum weight: " << mMinWeight << std::endl
+    << "merge tolerance: " << mMergeTol << std::endl
     << "valid: " << mValid;
 }
 
-template <typename C, size_t M>
-void EstimatorML<MixtureDistribution<C, M> >::read(std::ifstream& stream) {
+template <typename C, size_t M, typename S>
+void EstimatorML<MixtureDistribution<C, M>, S>::read(std::ifstream& stream) {
 }
 
-template <typename C, size_t M>
-void EstimatorML<MixtureDistribution<C, M> >::write(std::ofstream& stream)
+template <typename C, size_t M, typename S>
+void EstimatorML<MixtureDistribution<C, M>, S>::write(std::ofstream& stream)
     const {
 }
 
@@ -99,224 +156,657 @@ void EstimatorML<MixtureDistribution<C, M> >::write(std::ofstream& stream)
 /* Accessors                                                                  */
 /******************************************************************************/
 
-template <typename C, size_t M>
+template <typename C, size_t M, typename S>
 const MixtureDistribution<C, M>&
-    EstimatorML<MixtureDistribution<C, M> >::getMixtureDist() const {
+    EstimatorML<MixtureDistribution<C, M>, S>::getMixtureDist() const {
   return mMixtureDist;
 }
 
-template <typename C, size_t M>
+template <typename C, size_t M, typename S>
 const Eigen::Matrix<double, Eigen::Dynamic, M>&
-    EstimatorML<MixtureDistribution<C, M> >::getResponsibilities() const {
+    EstimatorML<MixtureDistribution<C, M>, S>::getResponsibilities() const {
   return mResponsibilities;
 }
 
-template <typename C, size_t M>
-size_t EstimatorML<MixtureDistribution<C, M> >::getNumPoints() const {
+template <typename C, size_t M, typename S>
+size_t EstimatorML<MixtureDistribution<C, M>, S>::getNumPoints() const {
   return mNumPoints;
 }
 
-template <typename C, size_t M>
-bool EstimatorML<MixtureDistribution<C, M> >::getValid() const {
+template <typename C, size_t M, typename S>
+bool EstimatorML<MixtureDistribution<C, M>, S>::getValid() const {
   return mValid;
 }
 
-template <typename C, size_t M>
-double EstimatorML<MixtureDistribution<C, M> >::getLogLikelihood() const {
+template <typename C, size_t M, typename S>
+double EstimatorML<MixtureDistribution<C, M>, S>::getLogLikelihood() const {
   return mLogLikelihood;
 }
 
-template <typename C, size_t M>
-double EstimatorML<MixtureDistribution<C, M> >::getTolerance() const {
+template <typename C, size_t M, typename S>
+double EstimatorML<MixtureDistribution<C, M>, S>::getTolerance() const {
   return mTol;
 }
 
-template <typename C, size_t M>
-void EstimatorML<MixtureDistribution<C, M> >::setTolerance(double tol) {
+template <typename C, size_t M, typename S>
+void EstimatorML<MixtureDistribution<C, M>, S>::setTolerance(double tol) {
   mTol = tol;
 }
 
-template <typename C, size_t M>
-size_t EstimatorML<MixtureDistribution<C, M> >::getMaxNumIter() const {
+template <typename C, size_t M, typename S>
+size_t EstimatorML<MixtureDistribution<C, M>, S>::getMaxNumIter() const {
   return mMaxNumIter;
 }
 
-template <typename C, size_t M>
-void EstimatorML<MixtureDistribution<C, M> >::setMaxNumIter(size_t maxNumIter) {
+template <typename C, size_t M, typename S>
+void EstimatorML<MixtureDistribution<C, M>, S>::setMaxNumIter(size_t
+    maxNumIter) {
   mMaxNumIter = maxNumIter;
 }
 
-template <typename C, size_t M>
-void EstimatorML<MixtureDistribution<C, M> >::reset() {
+template <typename C, size_t M, typename S>
+size_t EstimatorML<MixtureDistribution<C, M>, S>::getNumThreads() const {
+  return mNumThreads;
+}
+
+template <typename C, size_t M, typename S>
+void EstimatorML<MixtureDistribution<C, M>, S>::setNumThreads(size_t
+    numThreads) {
+  if (numThreads == mNumThreads)
+    return;
+  delete mThreadPool;
+  mThreadPool = 0;
+  mNumThreads = numThreads;
+}
+
+template <typename C, size_t M, typename S>
+size_t EstimatorML<MixtureDistribution<C, M>, S>::getBlockSize() const {
+  return mBlockSize;
+}
+
+template <typename C, size_t M, typename S>
+void EstimatorML<MixtureDistribution<C, M>, S>::setBlockSize(size_t blockSize) {
+  if (blockSize == 0)
+    throw BadArgumentException<size_t>(blockSize,
+      "EstimatorML<MixtureDistribution<C, M>, S>::setBlockSize(): "
+      "block size must be strictly positive",
+      __FILE__, __LINE__);
+  mBlockSize = blockSize;
+}
+
+template <typename C, size_t M, typename S>
+bool EstimatorML<MixtureDistribution<C, M>, S>::getAccelerated() const {
+  return mAccelerated;
+}
+
+template <typename C, size_t M, typename S>
+void EstimatorML<MixtureDistribution<C, M>, S>::setAccelerated(bool
+    accelerated) {
+  mAccelerated = accelerated;
+}
+
+template <typename C, size_t M, typename S>
+size_t EstimatorML<MixtureDistribution<C, M>, S>::getNumEMSteps() const {
+  return mNumEMSteps;
+}
+
+template <typename C, size_t M, typename S>
+size_t EstimatorML<MixtureDistribution<C, M>, S>::getNumExtrapolations() const {
+  return mNumExtrapolations;
+}
+
+template <typename C, size_t M, typename S>
+size_t EstimatorML<MixtureDistribution<C, M>, S>::getNumRejections() const {
+  return mNumRejections;
+}
+
+template <typename C, size_t M, typename S>
+double EstimatorML<MixtureDistribution<C, M>, S>::getStepExponent() const {
+  return mStepExponent;
+}
+
+template <typename C, size_t M, typename S>
+void EstimatorML<MixtureDistribution<C, M>, S>::setStepExponent(double
+    stepExponent) {
+  if (stepExponent <= 0.5 || stepExponent > 1.0)
+    throw BadArgumentException<double>(stepExponent,
+      "EstimatorML<MixtureDistribution<C, M>, S>::setStepExponent(): "
+      "step exponent must be in (0.5, 1]",
+      __FILE__, __LINE__);
+  mStepExponent = stepExponent;
+}
+
+template <typename C, size_t M, typename S>
+const Randomizer<double, M>& EstimatorML<MixtureDistribution<C, M>, S>::
+    getRandomizer() const {
+  return mRandomizer;
+}
+
+template <typename C, size_t M, typename S>
+void EstimatorML<MixtureDistribution<C, M>, S>::setRandomizer(const
+    Randomizer<double, M>& randomizer) {
+  mRandomizer = randomizer;
+}
+
+template <typename C, size_t M, typename S>
+double EstimatorML<MixtureDistribution<C, M>, S>::getMinWeight() const {
+  return mMinWeight;
+}
+
+template <typename C, size_t M, typename S>
+void EstimatorML<MixtureDistribution<C, M>, S>::setMinWeight(double minWeight) {
+  if (minWeight < 0 || minWeight >= 1.0)
+    throw BadArgumentException<double>(minWeight,
+      "EstimatorML<MixtureDistribution<C, M>, S>::setMinWeight(): "
+      "minimum weight must be in [0, 1)",
+      __FILE__, __LINE__);
+  mMinWeight = minWeight;
+}
+
+template <typename C, size_t M, typename S>
+double EstimatorML<MixtureDistribution<C, M>, S>::getMergeTolerance() const {
+  return mMergeTol;
+}
+
+template <typename C, size_t M, typename S>
+void EstimatorML<MixtureDistribution<C, M>, S>::setMergeTolerance(double
+    mergeTol) {
+  mMergeTol = mergeTol;
+}
+
+template <typename C, size_t M, typename S>
+size_t EstimatorML<MixtureDistribution<C, M>, S>::getNumUpdates() const {
+  return mNumUpdates;
+}
+
+template <typename C, size_t M, typename S>
+void EstimatorML<MixtureDistribution<C, M>, S>::reset() {
   mLogLikelihood = 0;
   mNumPoints = 0;
   mValid = false;
+  mNumEMSteps = 0;
+  mNumExtrapolations = 0;
+  mNumRejections = 0;
+  mNumUpdates = 0;
+}
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+template <typename C, size_t M, typename S>
+typename EstimatorML<MixtureDistribution<C, M>, S>::BlockStatistics&
+    EstimatorML<MixtureDistribution<C, M>, S>::BlockStatistics::operator +=
+    (const BlockStatistics& other) {
+  mLogLikelihood += other.mLogLikelihood;
+  mNumPoints += other.mNumPoints;
+  for (size_t j = 0; j < mMoments.size(); ++j)
+    mMoments[j] += other.mMoments[j];
+  return *this;
+}
+
+template <typename C, size_t M, typename S>
+void EstimatorML<MixtureDistribution<C, M>, S>::BlockTask::process(size_t
+    block) {
+  mEstimator.processBlock(block, mStep);
+}
+
+template <typename C, size_t M, typename S>
+void EstimatorML<MixtureDistribution<C, M>, S>::initBlocks(const
+    ConstPointIterator& itStart, const ConstPointIterator& itEnd) {
+  const size_t numPointsTotal = itEnd - itStart;
+  const size_t numBlocks = (numPointsTotal + mBlockSize - 1) / mBlockSize;
+  const size_t K = mMixtureDist.getCompDistributions().size();
+  mBlockPoints.resize(numBlocks);
+  mBlockResponsibilities.resize(numBlocks);
+  mBlockAssignments.resize(numBlocks);
+  mBlockStatistics.resize(numBlocks);
+  for (size_t b = 0; b < numBlocks; ++b) {
+    const size_t start = b * mBlockSize;
+    const size_t numPoints = std::min(mBlockSize, numPointsTotal - start);
+    mBlockPoints[b].resize(numPoints, itStart->size());
+    for (size_t i = 0; i < numPoints; ++i)
+      mBlockPoints[b].row(i) =
+        (itStart + start + i)->transpose().template cast<S>();
+    mBlockResponsibilities[b].resize(numPoints, K);
+    mBlockAssignments[b].resize(numPoints);
+    mBlockStatistics[b].mLogLikelihood = 0;
+    mBlockStatistics[b].mNumPoints =
+      Eigen::Matrix<double, Eigen::Dynamic, 1>::Zero(K);
+    mBlockStatistics[b].mMoments.resize(K);
+  }
+}
+
+template <typename C, size_t M, typename S>
+void EstimatorML<MixtureDistribution<C, M>, S>::processBlock(size_t block, Step
+    step) {
+  const Points& points = mBlockPoints[block];
+  Responsibilities& responsibilities = mBlockResponsibilities[block];
+  std::vector<size_t>& assignments = mBlockAssignments[block];
+  BlockStatistics& statistics = mBlockStatistics[block];
+  const size_t K = mMixtureDist.getCompDistributions().size();
+  const size_t numPoints = points.rows();
+  statistics.mLogLikelihood =
+    mMixtureDist.getResponsibilities(points, responsibilities);
+  if (step == expectation)
+    return;
+  statistics.mNumPoints.resize(K);
+  statistics.mMoments.resize(K);
+  if (step == expectationMaximization) {
+    for (size_t j = 0; j < K; ++j) {
+      statistics.mMoments[j] = EstimatorML<C>::getMoments(points,
+        responsibilities.col(j));
+      statistics.mNumPoints(j) = statistics.mMoments[j](0, 0);
+    }
+    return;
+  }
+  if (step == classificationMaximization)
+    for (size_t i = 0; i < numPoints; ++i) {
+      double max = -std::numeric_limits<double>::infinity();
+      size_t argmax = 0;
+      for (size_t j = 0; j < K; ++j)
+        if (responsibilities(i, j) > max) {
+          max = responsibilities(i, j);
+          argmax = j;
+        }
+      assignments[i] = argmax;
+    }
+  else
+    for (size_t i = 0; i < numPoints; ++i) {
+      responsibilities.row(i) /= responsibilities.row(i).sum();
+      assignments[i] = mBlockRandomizers[block].sampleCategorical(
+        responsibilities.row(i).transpose().template cast<double>());
+    }
+  for (size_t j = 0; j < K; ++j)
+    statistics.mMoments[j] = EstimatorML<C>::Moments::Zero();
+  for (size_t i = 0; i < numPoints; ++i)
+    EstimatorML<C>::addMoments(statistics.mMoments[assignments[i]],
+      points.row(i), 1.0);
+  for (size_t j = 0; j < K; ++j)
+    statistics.mNumPoints(j) = statistics.mMoments[j](0, 0);
+}
+
+template <typename C, size_t M, typename S>
+ThreadPool& EstimatorML<MixtureDistribution<C, M>, S>::getThreadPool() {
+  if (!mThreadPool)
+    mThreadPool = new ThreadPool(mNumThreads);
+  return *mThreadPool;
+}
+
+template <typename C, size_t M, typename S>
+void EstimatorML<MixtureDistribution<C, M>, S>::processBlocks(ThreadPool& pool,
+    Step step) {
+  BlockTask task(*this, step);
+  pool.process(task, mBlockPoints.size());
+}
+
+template <typename C, size_t M, typename S>
+typename EstimatorML<MixtureDistribution<C, M>, S>::BlockStatistics
+    EstimatorML<MixtureDistribution<C, M>, S>::reduceBlocks() const {
+  std::vector<BlockStatistics> statistics(mBlockStatistics);
+  ThreadPool::reduce(statistics);
+  return statistics[0];
 }
 
-template <typename C, size_t M>
-size_t EstimatorML<MixtureDistribution<C, M> >::
+template <typename C, size_t M, typename S>
+void EstimatorML<MixtureDistribution<C, M>, S>::updateMixture(const
+    BlockStatistics& statistics) {
+  const size_t K = mMixtureDist.getCompDistributions().size();
+  mMixtureDist.setAssignDistribution(CategoricalDistribution<M>(
+    statistics.mNumPoints / mNumPoints));
+  for (size_t j = 0; j < K; ++j) {
+    EstimatorML<C> estComp;
+    estComp.addPoints(statistics.mMoments[j], mNumPoints);
+    if (estComp.getValid())
+      mMixtureDist.setCompDistribution(estComp.getDistribution(), j);
+  }
+}
+
+template <typename C, size_t M, typename S>
+bool EstimatorML<MixtureDistribution<C, M>, S>::simplifyMixture(const
+    BlockStatistics& statistics) {
+  if (mMinWeight <= 0 && mMergeTol <= 0)
+    return false;
+  const size_t K = mMixtureDist.getCompDistributions().size();
+  std::vector<size_t> representatives;
+  std::vector<int> groups(K, -1);
+  for (size_t j = 0; j < K; ++j) {
+    if (statistics.mNumPoints(j) < mMinWeight * mNumPoints)
+      continue;
+    const C& component = mMixtureDist.getCompDistribution(j);
+    for (size_t r = 0; r < representatives.size(); ++r)
+      if (mMergeTol > 0 && (mMixtureDist.getCompDistribution(
+          representatives[r]).getLinearBasisFunction().getCoefficients() -
+          component.getLinearBasisFunction().getCoefficients()).norm() <
+          mMergeTol) {
+        groups[j] = r;
+        break;
+      }
+    if (groups[j] < 0) {
+      groups[j] = representatives.size();
+      representatives.push_back(j);
+    }
+  }
+  if (representatives.size() == K || representatives.empty())
+    return false;
+  BlockStatistics simplified;
+  simplified.mLogLikelihood = statistics.mLogLikelihood;
+  simplified.mNumPoints = Eigen::Matrix<double, Eigen::Dynamic, 1>::Zero(
+    representatives.size());
+  simplified.mMoments.resize(representatives.size());
+  std::vector<C> components;
+  components.reserve(representatives.size());
+  for (size_t r = 0; r < representatives.size(); ++r) {
+    simplified.mMoments[r] = statistics.mMoments[representatives[r]];
+    simplified.mMoments[r].setZero();
+    components.push_back(mMixtureDist.getCompDistribution(
+      representatives[r]));
+  }
+  for (size_t j = 0; j < K; ++j)
+    if (groups[j] >= 0) {
+      simplified.mNumPoints(groups[j]) += statistics.mNumPoints(j);
+      simplified.mMoments[groups[j]] += statistics.mMoments[j];
+    }
+  simplified.mNumPoints *= mNumPoints / simplified.mNumPoints.sum();
+  mMixtureDist.setCompDistributions(components);
+  updateMixture(simplified);
+  return true;
+}
+
+template <typename C, size_t M, typename S>
+void EstimatorML<MixtureDistribution<C, M>, S>::gatherResponsibilities() {
+  const size_t K = mMixtureDist.getCompDistributions().size();
+  for (size_t b = 0; b < mBlockResponsibilities.size(); ++b)
+    if ((size_t)mBlockResponsibilities[b].cols() != K) {
+      processBlocks(getThreadPool(), expectation);
+      break;
+    }
+  size_t numRows = 0;
+  for (size_t b = 0; b < mBlockResponsibilities.size(); ++b)
+    numRows += mBlockResponsibilities[b].rows();
+  mResponsibilities.resize(numRows, K);
+  size_t row = 0;
+  for (size_t b = 0; b < mBlockResponsibilities.size(); ++b) {
+    const size_t numPoints = mBlockResponsibilities[b].rows();
+    mResponsibilities.block(row, 0, numPoints, K) =
+      mBlockResponsibilities[b].template cast<double>();
+    row += numPoints;
+  }
+}
+
+template <typename C, size_t M, typename S>
+double EstimatorML<MixtureDistribution<C, M>, S>::stepEM(ThreadPool& pool) {
+  processBlocks(pool, expectationMaximization);
+  const BlockStatistics statistics = reduceBlocks();
+  mNumEMSteps++;
+  updateMixture(statistics);
+  return statistics.mLogLikelihood;
+}
+
+template <typename C, size_t M, typename S>
+Eigen::Matrix<double, Eigen::Dynamic, 1>
+    EstimatorML<MixtureDistribution<C, M>, S>::getParameters() const {
+  const size_t K = mMixtureDist.getCompDistributions().size();
+  const size_t D = mMixtureDist.getCompDistribution(0).
+    getLinearBasisFunction().getCoefficients().size();
+  Eigen::Matrix<double, Eigen::Dynamic, 1> parameters(K * (D + 2));
+  parameters.start(K) =
+    mMixtureDist.getAssignDistribution().getProbabilities();
+  for (size_t j = 0; j < K; ++j) {
+    const C& component = mMixtureDist.getCompDistribution(j);
+    parameters.segment(K + j * (D + 1), D) =
+      component.getLinearBasisFunction().getCoefficients();
+    parameters(K + j * (D + 1) + D) = component.getVariance();
+  }
+  return parameters;
+}
+
+template <typename C, size_t M, typename S>
+bool EstimatorML<MixtureDistribution<C, M>, S>::setParameters(const
+    Eigen::Matrix<double, Eigen::Dynamic, 1>& parameters) {
+  const size_t K = mMixtureDist.getCompDistributions().size();
+  const size_t D = parameters.size() / K - 2;
+  for (size_t i = 0; i < (size_t)parameters.size(); ++i)
+    if (std::isnan(parameters(i)) || std::isinf(parameters(i)))
+      return false;
+  for (size_t j = 0; j < K; ++j)
+    if (parameters(j) < 0 || parameters(K + j * (D + 1) + D) <= 0)
+      return false;
+  const double sum = parameters.start(K).sum();
+  if (sum <= 0)
+    return false;
+  std::vector<C> components(mMixtureDist.getCompDistributions());
+  for (size_t j = 0; j < K; ++j) {
+    const typename C::RandomVariable coefficients =
+      parameters.segment(K + j * (D + 1), D);
+    components[j].setLinearBasisFunction(
+      typename C::LinearBasisFunctionType(coefficients));
+    components[j].setVariance(parameters(K + j * (D + 1) + D));
+  }
+  mMixtureDist.setAssignDistribution(CategoricalDistribution<M>(
+    parameters.start(K) / sum));
+  mMixtureDist.setCompDistributions(components);
+  return true;
+}
+
+template <typename C, size_t M, typename S>
+size_t EstimatorML<MixtureDistribution<C, M>, S>::accelerateEM(ThreadPool&
+    pool) {
+  while (mNumEMSteps < mMaxNumIter) {
+    mValid = true;
+    try {
+      const Eigen::Matrix<double, Eigen::Dynamic, 1> theta0 = getParameters();
+      processBlocks(pool, expectationMaximization);
+      const BlockStatistics statistics = reduceBlocks();
+      mNumEMSteps++;
+      if (fabs(mLogLikelihood - statistics.mLogLikelihood) < mTol)
+        break;
+      mLogLikelihood = statistics.mLogLikelihood;
+      updateMixture(statistics);
+      if (simplifyMixture(statistics)) {
+        mLogLikelihood = -std::numeric_limits<double>::infinity();
+        continue;
+      }
+      const Eigen::Matrix<double, Eigen::Dynamic, 1> theta1 = getParameters();
+      if (mNumEMSteps == mMaxNumIter)
+        break;
+      const double logLikelihood1 = stepEM(pool);
+      const Eigen::Matrix<double, Eigen::Dynamic, 1> theta2 = getParameters();
+      const Eigen::Matrix<double, Eigen::Dynamic, 1> r = theta1 - theta0;
+      const Eigen::Matrix<double, Eigen::Dynamic, 1> v = theta2 - theta1 - r;
+      double alpha = v.norm() > 0 ? -r.norm() / v.norm() : -1.0;
+      const bool extrapolate = alpha < -1.0;
+      bool accepted = false;
+      while (alpha < -1.0 && mNumEMSteps < mMaxNumIter) {
+        if (setParameters(theta0 - 2.0 * alpha * r + alpha * alpha * v)) {
+          processBlocks(pool, expectationMaximization);
+          const BlockStatistics extrapolated = reduceBlocks();
+          mNumEMSteps++;
+          if (extrapolated.mLogLikelihood >= logLikelihood1) {
+            updateMixture(extrapolated);
+            accepted = true;
+            break;
+          }
+        }
+        alpha = (alpha - 1.0) / 2.0;
+      }
+      if (accepted)
+        mNumExtrapolations++;
+      else {
+        if (extrapolate)
+          mNumRejections++;
+        setParameters(theta2);
+      }
+    }
+    catch (...) {
+      mValid = false;
+      break;
+    }
+  }
+  return mNumEMSteps;
+}
+
+template <typename C, size_t M, typename S>
+size_t EstimatorML<MixtureDistribution<C, M>, S>::
     addPointsEM(const ConstPointIterator& itStart, const ConstPointIterator&
     itEnd) {
   reset();
   size_t numIter = 0;
-  const size_t K = mMixtureDist.getCompDistributions().size();
   mNumPoints = itEnd - itStart;
   if (mNumPoints == 0)
     return numIter;
-  mResponsibilities.resize(mNumPoints, K);
   mLogLikelihood = -std::numeric_limits<double>::infinity();
-  const LogSumExpFunction<double, M> lse;
-  Eigen::Matrix<double, M, 1> logProbabilities(K);
+  initBlocks(itStart, itEnd);
+  ThreadPool& pool = getThreadPool();
+  if (mAccelerated) {
+    numIter = accelerateEM(pool);
+    gatherResponsibilities();
+    return numIter;
+  }
   while (numIter != mMaxNumIter) {
     mValid = true;
-    double logLikelihood = 0;
-    Eigen::Matrix<double, M, 1> numPoints =
-      Eigen::Matrix<double, M, 1>::Zero(K);
-    for (auto it = itStart; it != itEnd; ++it) {
-      const size_t row = it - itStart;
-      for (size_t j = 0; j < K; ++j)
-        logProbabilities(j) =
-          log(mMixtureDist.getAssignDistribution().getProbability(j)) +
-           mMixtureDist.getCompDistribution(j).logpdf(*it);
-      const double lseProb = lse(logProbabilities);
-      logLikelihood += lseProb;
-      mResponsibilities.row(row) = (logProbabilities.cwise() - lseProb).cwise().
-        exp();
-      numPoints += mResponsibilities.row(row).transpose();
-    }
-    if (fabs(mLogLikelihood - logLikelihood) < mTol)
+    processBlocks(pool, expectationMaximization);
+    const BlockStatistics statistics = reduceBlocks();
+    mNumEMSteps++;
+    if (fabs(mLogLikelihood - statistics.mLogLikelihood) < mTol)
       break;
-    mLogLikelihood = logLikelihood;
+    mLogLikelihood = statistics.mLogLikelihood;
     try {
-      mMixtureDist.setAssignDistribution(CategoricalDistribution<M>(
-        numPoints / mNumPoints));
-      for (size_t j = 0; j < K; ++j) {
-        EstimatorML<C> estComp;
-        estComp.addPoints(itStart, itEnd, mResponsibilities.col(j));
-        if (estComp.getValid())
-          mMixtureDist.setCompDistribution(estComp.getDistribution(), j);
-      }
+      updateMixture(statistics);
+      if (simplifyMixture(statistics))
+        mLogLikelihood = -std::numeric_limits<double>::infinity();
     }
     catch (...) {
       mValid = false;
     }
     numIter++;
   }
+  gatherResponsibilities();
   return numIter;
 }
 
-template <typename C, size_t M>
-size_t EstimatorML<MixtureDistribution<C, M> >::
+template <typename C, size_t M, typename S>
+size_t EstimatorML<MixtureDistribution<C, M>, S>::
     addPointsCEM(const ConstPointIterator& itStart, const ConstPointIterator&
     itEnd) {
   reset();
   size_t numIter = 0;
-  const size_t K = mMixtureDist.getCompDistributions().size();
   mNumPoints = itEnd - itStart;
   if (mNumPoints == 0)
     return numIter;
-  mResponsibilities.resize(mNumPoints, K);
   mLogLikelihood = -std::numeric_limits<double>::infinity();
-  const LogSumExpFunction<double, M> lse;
-  Eigen::Matrix<double, M, 1> logProbabilities(K);
+  initBlocks(itStart, itEnd);
+  ThreadPool& pool = getThreadPool();
   while (numIter != mMaxNumIter) {
     mValid = true;
-    double logLikelihood = 0;
-    std::vector<EstimatorML<C> > estComp(K);
-    Eigen::Matrix<size_t, M, 1> numPoints =
-      Eigen::Matrix<size_t, M, 1>::Zero(K);
-    for (auto it = itStart; it != itEnd; ++it) {
-      const size_t row = it - itStart;
-      double max = -std::numeric_limits<double>::infinity();
-      size_t argmax = 0;
-      for (size_t j = 0; j < K; ++j) {
-        logProbabilities(j) =
-          log(mMixtureDist.getAssignDistribution().getProbability(j)) +
-          mMixtureDist.getCompDistribution(j).logpdf(*it);
-        if (logProbabilities(j) > max) {
-          max = logProbabilities(j);
-          argmax = j;
-        }
-      }
-      const double lseProb = lse(logProbabilities);
-      logLikelihood += lseProb;
-      mResponsibilities.row(row) = (logProbabilities.cwise() - lseProb).cwise().
-        exp();
-      estComp[argmax].addPoint(*it);
-      numPoints(argmax)++;
-    }
-    if (fabs(mLogLikelihood - logLikelihood) < mTol)
+    processBlocks(pool, classificationMaximization);
+    const BlockStatistics statistics = reduceBlocks();
+    if (fabs(mLogLikelihood - statistics.mLogLikelihood) < mTol)
       break;
-    mLogLikelihood = logLikelihood;
+    mLogLikelihood = statistics.mLogLikelihood;
     try {
-      mMixtureDist.setAssignDistribution(CategoricalDistribution<M>(
-        numPoints.template cast<double>() / mNumPoints));
-      for (size_t j = 0; j < K; ++j)
-        mMixtureDist.setCompDistribution(estComp[j].getDistribution(), j);
+      updateMixture(statistics);
+      if (simplifyMixture(statistics))
+        mLogLikelihood = -std::numeric_limits<double>::infinity();
     }
     catch (...) {
       mValid = false;
     }
     numIter++;
   }
+  gatherResponsibilities();
   return numIter;
 }
 
-template <typename C, size_t M>
-size_t EstimatorML<MixtureDistribution<C, M> >::
+template <typename C, size_t M, typename S>
+size_t EstimatorML<MixtureDistribution<C, M>, S>::
     addPointsSEM(const ConstPointIterator& itStart, const ConstPointIterator&
     itEnd) {
   reset();
   size_t numIter = 0;
-  const size_t K = mMixtureDist.getCompDistributions().size();
   mNumPoints = itEnd - itStart;
   if (mNumPoints == 0)
     return numIter;
-  mResponsibilities.resize(mNumPoints, K);
   mLogLikelihood = -std::numeric_limits<double>::infinity();
-  const static Randomizer<double, M> randomizer;
-  const LogSumExpFunction<double, M> lse;
-  Eigen::Matrix<double, M, 1> logProbabilities(K);
+  initBlocks(itStart, itEnd);
+  mBlockRandomizers.clear();
+  mBlockRandomizers.reserve(mBlockPoints.size());
+  for (size_t b = 0; b < mBlockPoints.size(); ++b) {
+    mRandomizer.jump();
+    mBlockRandomizers.push_back(mRandomizer);
+  }
+  ThreadPool& pool = getThreadPool();
   while (numIter != mMaxNumIter) {
     mValid = true;
-    double logLikelihood = 0;
-    std::vector<EstimatorML<C> > estComp(K);
-    Eigen::Matrix<size_t, M, 1> numPoints =
-      Eigen::Matrix<size_t, M, 1>::Zero(K);
-    for (auto it = itStart; it != itEnd; ++it) {
-      const size_t row = it - itStart;
-      for (size_t j = 0; j < K; ++j)
-        logProbabilities(j) =
-          log(mMixtureDist.getAssignDistribution().getProbability(j)) +
-          mMixtureDist.getCompDistribution(j).logpdf(*it);
-      const double lseProb = lse(logProbabilities);
-      logLikelihood += lseProb;
-      mResponsibilities.row(row) = (logProbabilities.cwise() - lseProb).cwise().
-        exp();
-      const size_t assignment =
-        randomizer.sampleCategorical(mResponsibilities.row(row));
-      estComp[assignment].addPoint(*it);
-      numPoints(assignment)++;
-    }
-    if (fabs(mLogLikelihood - logLikelihood) < mTol)
+    processBlocks(pool, stochasticMaximization);
+    const BlockStatistics statistics = reduceBlocks();
+    if (fabs(mLogLikelihood - statistics.mLogLikelihood) < mTol)
       break;
-    mLogLikelihood = logLikelihood;
+    mLogLikelihood = statistics.mLogLikelihood;
     try {
-      mMixtureDist.setAssignDistribution(CategoricalDistribution<M>(
-        numPoints.template cast<double>() / mNumPoints));
-      for (size_t j = 0; j < K; ++j)
-        mMixtureDist.setCompDistribution(estComp[j].getDistribution(), j);
+      updateMixture(statistics);
+      if (simplifyMixture(statistics))
+        mLogLikelihood = -std::numeric_limits<double>::infinity();
     }
     catch (...) {
       mValid = false;
     }
     numIter++;
   }
+  gatherResponsibilities();
   return numIter;
 }
 
-template <typename C, size_t M>
-size_t EstimatorML<MixtureDistribution<C, M> >::addPoints(const Container&
+template <typename C, size_t M, typename S>
+void EstimatorML<MixtureDistribution<C, M>, S>::
+    addPointsOnline(const ConstPointIterator& itStart, const
+    ConstPointIterator& itEnd) {
+  const size_t numPoints = itEnd - itStart;
+  if (numPoints == 0)
+    return;
+  const size_t K = mMixtureDist.getCompDistributions().size();
+  initBlocks(itStart, itEnd);
+  ThreadPool& pool = getThreadPool();
+  processBlocks(pool, expectationMaximization);
+  const BlockStatistics statistics = reduceBlocks();
+  gatherResponsibilities();
+  mLogLikelihood = statistics.mLogLikelihood;
+  const double stepSize = pow(mNumUpdates + 1.0, -mStepExponent);
+  if (mNumUpdates == 0) {
+    mOnlineStatistics.mLogLikelihood = 0;
+    mOnlineStatistics.mNumPoints =
+      Eigen::Matrix<double, Eigen::Dynamic, 1>::Zero(K);
+    mOnlineStatistics.mMoments = statistics.mMoments;
+    for (size_t j = 0; j < K; ++j)
+      mOnlineStatistics.mMoments[j].setZero();
+  }
+  mOnlineStatistics.mLogLikelihood = (1.0 - stepSize) *
+    mOnlineStatistics.mLogLikelihood + stepSize *
+    statistics.mLogLikelihood / numPoints;
+  mOnlineStatistics.mNumPoints = (1.0 - stepSize) *
+    mOnlineStatistics.mNumPoints + stepSize * statistics.mNumPoints /
+    numPoints;
+  for (size_t j = 0; j < K; ++j)
+    mOnlineStatistics.mMoments[j] = (1.0 - stepSize) *
+      mOnlineStatistics.mMoments[j] + stepSize * statistics.mMoments[j] /
+      numPoints;
+  mNumUpdates++;
+  mNumPoints += numPoints;
+  BlockStatistics scaledStatistics(mOnlineStatistics);
+  scaledStatistics.mNumPoints *= mNumPoints;
+  for (size_t j = 0; j < K; ++j)
+    scaledStatistics.mMoments[j] *= mNumPoints;
+  mValid = true;
+  try {
+    updateMixture(scaledStatistics);
+  }
+  catch (...) {
+    mValid = false;
+  }
+}
+
+template <typename C, size_t M, typename S>
+size_t EstimatorML<MixtureDistribution<C, M>, S>::addPoints(const Container&
     points) {
   return addPointsEM(points.begin(), points.end());
 }
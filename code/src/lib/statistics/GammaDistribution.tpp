@@ -150,7 +150,7 @@ double GammaDistribution<T>::cdf(const RandomVariable& value) const {
 template <typename T>
 typename GammaDistribution<T>::RandomVariable GammaDistribution<T>::getSample()
     const {
-  const static Randomizer<double> randomizer;
+  const Randomizer<double>& randomizer = Randomizer<double>::getLocal();
   return randomizer.sampleGamma(mShape, mInvScale);
 }
 
@@ -102,7 +102,7 @@ double GeometricDistribution::cdf(const RandomVariable& value) const {
 }
 
 GeometricDistribution::RandomVariable GeometricDistribution::getSample() const {
-  const static Randomizer<double> randomizer;
+  const Randomizer<double>& randomizer = Randomizer<double>::getLocal();
   return randomizer.sampleGeometric(mProbability);
 }
 
@@ -147,7 +147,7 @@ double InvGammaDistribution<T>::cdf(const RandomVariable& value) const {
 template <typename T>
 typename InvGammaDistribution<T>::RandomVariable
     InvGammaDistribution<T>::getSample() const {
-  const static Randomizer<double> randomizer;
+  const Randomizer<double>& randomizer = Randomizer<double>::getLocal();
   return 1.0 / randomizer.sampleGamma(mShape, mScale);
 }
 
@@ -44,6 +44,11 @@ public:
   typedef ContinuousDistribution<double, M> DistributionType;
   /// Random variable type
   typedef typename DistributionType::RandomVariable RandomVariable;
+  /// Block of random variables, one row per point and one column per
+  /// coordinate
+  typedef Eigen::Matrix<double, Eigen::Dynamic, M> RandomVariables;
+  /// Linear basis function type
+  typedef LinearBasisFunction<double, M> LinearBasisFunctionType;
   /** @}
     */
 
@@ -122,6 +127,10 @@ public:
   virtual double pdf(const RandomVariable& value) const;
   /// Access the log-probability density function at the given value
   double logpdf(const RandomVariable& value) const;
+  /// Access the log-probability density function for a block of values
+  /// stored with scalar type S
+  template <typename S> void logpdf(const Eigen::Matrix<S, Eigen::Dynamic, M>&
+    values, Eigen::Matrix<S, Eigen::Dynamic, 1>& logProbabilities) const;
   /// Access a sample drawn from the distribution
   virtual RandomVariable getSample() const;
   /** @}
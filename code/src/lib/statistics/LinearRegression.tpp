@@ -16,6 +16,8 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
  ******************************************************************************/
 
+#include <Eigen/Array>
+
 #include "statistics/NormalDistribution.h"
 
 /******************************************************************************/
@@ -197,6 +199,18 @@ double LinearRegression<M>::logpdf(const RandomVariable& value) const {
   return Traits<M>::logpdf(*this, value);
 }
 
+template <size_t M>
+template <typename S>
+void LinearRegression<M>::logpdf(const Eigen::Matrix<S, Eigen::Dynamic, M>&
+    values, Eigen::Matrix<S, Eigen::Dynamic, 1>& logProbabilities) const {
+  const Eigen::Matrix<S, M, 1> coefficients =
+    mLinearBasisFunction.getCoefficients().template cast<S>();
+  logProbabilities = ((values.col(M - 1) -
+    values.block(0, 0, values.rows(), M - 1) * coefficients.end(M - 1)).
+    cwise() - coefficients(0)).cwise().square() * S(-0.5 / mVariance);
+  logProbabilities.cwise() -= S(0.5 * log(2.0 * M_PI * mVariance));
+}
+
 template <size_t M>
 typename  LinearRegression<M>::RandomVariable
     LinearRegression<M>::getSample() const {
@@ -110,7 +110,7 @@ double LogisticDistribution::cdf(const RandomVariable& value) const {
 }
 
 LogisticDistribution::RandomVariable LogisticDistribution::getSample() const {
-  const static Randomizer<double> randomizer;
+  const Randomizer<double>& randomizer = Randomizer<double>::getLocal();
   double y = 0;
   while (y == 0)
     y = randomizer.sampleUniform();
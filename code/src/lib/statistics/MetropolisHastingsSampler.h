@@ -28,6 +28,7 @@
 
 #include "functions/ContinuousFunction.h"
 #include "statistics/NormalDistribution.h"
+#include "statistics/Randomizer.h"
 
 /** The MetropolisHastingsSampler namespace implements Metropolis-Hastings
     sampling.
@@ -43,6 +44,12 @@ namespace MetropolisHastingsSampler {
     NormalDistribution<M>& proposal,
     std::vector<typename NormalDistribution<M>::RandomVariable>& samples, size_t
     numSamples);
+  /// Access samples with the acceptance draws taken from a given randomizer
+  template <typename Y, typename X, size_t M>
+  void getSamples(const ContinuousFunction<Y, X, M>& target,
+    NormalDistribution<M>& proposal,
+    std::vector<typename NormalDistribution<M>::RandomVariable>& samples, size_t
+    numSamples, const Randomizer<double>& randomizer);
   /** @}
     */
 
@@ -16,8 +16,6 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
  ******************************************************************************/
 
-#include "statistics/Randomizer.h"
-
 namespace MetropolisHastingsSampler {
 
 /******************************************************************************/
@@ -29,10 +27,18 @@ void getSamples(const ContinuousFunction<Y, X, M>& target,
     NormalDistribution<M>& proposal,
     std::vector<typename NormalDistribution<M>::RandomVariable>& samples, size_t
     numSamples) {
+  const Randomizer<double> randomizer;
+  getSamples(target, proposal, samples, numSamples, randomizer);
+}
+
+template <typename Y, typename X, size_t M>
+void getSamples(const ContinuousFunction<Y, X, M>& target,
+    NormalDistribution<M>& proposal,
+    std::vector<typename NormalDistribution<M>::RandomVariable>& samples, size_t
+    numSamples, const Randomizer<double>& randomizer) {
   samples.clear();
   samples.reserve(numSamples);
   samples.push_back(proposal.getSample());
-  static const Randomizer<double> randomizer;
   while (samples.size() != numSamples) {
     proposal.setMean(samples.back());
     const typename NormalDistribution<M>::RandomVariable sample =
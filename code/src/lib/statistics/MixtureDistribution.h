@@ -79,6 +79,13 @@ public:
   virtual double pdf(const RandomVariable& value) const;
   /// Returns the probability mass function at the given value
   virtual double pmf(const RandomVariable& value) const;
+  /// Fills the joint log-probabilities of a block of values, one row per
+  /// value and one column per component
+  template <typename B, typename S> void getLogProbabilities(const B& values,
+    Eigen::Matrix<S, Eigen::Dynamic, M>& logProbabilities) const;
+  /// Fills the responsibilities of a block of values / Returns log-likelihood
+  template <typename B, typename S> double getResponsibilities(const B&
+    values, Eigen::Matrix<S, Eigen::Dynamic, M>& responsibilities) const;
   /** @}
     */
 
@@ -16,6 +16,9 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
  ******************************************************************************/
 
+#include <Eigen/Array>
+
+#include "functions/LogSumExpFunction.h"
 #include "exceptions/BadArgumentException.h"
 
 /******************************************************************************/
@@ -134,3 +137,31 @@ template <typename D, size_t M>
 double MixtureDistribution<D, M>::pmf(const RandomVariable& value) const {
   return pdf(value);
 }
+
+template <typename D, size_t M>
+template <typename B, typename S>
+void MixtureDistribution<D, M>::getLogProbabilities(const B& values,
+    Eigen::Matrix<S, Eigen::Dynamic, M>& logProbabilities) const {
+  const size_t K = mCompDistributions.size();
+  logProbabilities.resize(values.rows(), K);
+  Eigen::Matrix<S, Eigen::Dynamic, 1> compLogProbabilities(values.rows());
+  for (size_t j = 0; j < K; ++j) {
+    mCompDistributions[j].logpdf(values, compLogProbabilities);
+    logProbabilities.col(j) = compLogProbabilities.cwise() +
+      S(log(mAssignDistribution.getProbability(j)));
+  }
+}
+
+template <typename D, size_t M>
+template <typename B, typename S>
+double MixtureDistribution<D, M>::getResponsibilities(const B& values,
+    Eigen::Matrix<S, Eigen::Dynamic, M>& responsibilities) const {
+  getLogProbabilities(values, responsibilities);
+  const LogSumExpFunction<S, M> lse;
+  Eigen::Matrix<double, Eigen::Dynamic, 1> lseProbabilities;
+  lse.getRowValues(responsibilities, lseProbabilities);
+  for (size_t j = 0; j < (size_t)responsibilities.cols(); ++j)
+    responsibilities.col(j) = (responsibilities.col(j).template cast<double>() -
+      lseProbabilities).cwise().exp().template cast<S>();
+  return lseProbabilities.sum();
+}
@@ -54,7 +54,7 @@ MixtureSampleDistribution<D, M>::~MixtureSampleDistribution() {
 template <typename D, size_t M>
 typename MixtureSampleDistribution<D, M>::RandomVariable
     MixtureSampleDistribution<D, M>::getSample() const {
-  const static Randomizer<double, M> randomizer;
+  const Randomizer<double, M>& randomizer = Randomizer<double, M>::getLocal();
   return this->mCompDistributions[randomizer.sampleCategorical(
     this->mAssignDistribution.getProbabilities())].getSample();
 }
@@ -62,7 +62,7 @@ typename MixtureSampleDistribution<D, M>::RandomVariable
 template <typename D, size_t M>
 typename MixtureSampleDistribution<D, M>::JointRandomVariable
     MixtureSampleDistribution<D, M>::getJointSample() const {
-  const static Randomizer<double, M> randomizer;
+  const Randomizer<double, M>& randomizer = Randomizer<double, M>::getLocal();
   const size_t assignment = randomizer.sampleCategorical(
     this->mAssignDistribution.getProbabilities());
   return JointRandomVariable(this->mCompDistributions[assignment].getSample(),
@@ -202,7 +202,7 @@ double MultinomialDistribution<M>::logpmf(const typename
 template <size_t M>
 typename MultinomialDistribution<M>::RandomVariable
     MultinomialDistribution<M>::getSample() const {
-  const static Randomizer<double, M> randomizer;
+  const Randomizer<double, M>& randomizer = Randomizer<double, M>::getLocal();
   RandomVariable sampleVector =
     RandomVariable::Zero(mProbabilities.size());
   for (size_t i = 0; i < mNumTrials; ++i)
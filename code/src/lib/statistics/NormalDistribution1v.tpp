@@ -129,7 +129,7 @@ double NormalDistribution<1>::cdf(const RandomVariable& value) const {
 }
 
 NormalDistribution<1>::RandomVariable NormalDistribution<1>::getSample() const {
-  const static Randomizer<double> randomizer;
+  const Randomizer<double>& randomizer = Randomizer<double>::getLocal();
   return randomizer.sampleNormal(mMean, mVariance);
 }
 
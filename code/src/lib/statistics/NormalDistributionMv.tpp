@@ -169,7 +169,7 @@ template <size_t M>
 typename NormalDistribution<M>::RandomVariable
     NormalDistribution<M>::getSample() const {
   RandomVariable sample(mMean.size());
-  const static Randomizer<double> randomizer;
+  const Randomizer<double>& randomizer = Randomizer<double>::getLocal();
   for (size_t i = 0; i < (size_t)mMean.size(); ++i)
     sample(i) = randomizer.sampleNormal();
   return mMean + mTransformation.matrixL() * sample;
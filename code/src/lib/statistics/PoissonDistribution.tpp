@@ -106,7 +106,7 @@ double PoissonDistribution::cdf(const RandomVariable& value) const {
 }
 
 PoissonDistribution::RandomVariable PoissonDistribution::getSample() const {
-  const static Randomizer<double> randomizer;
+  const Randomizer<double>& randomizer = Randomizer<double>::getLocal();
   return randomizer.samplePoisson(mMean);
 }
 
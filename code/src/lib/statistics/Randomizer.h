@@ -24,12 +24,20 @@
 #ifndef RANDOMIZER_H
 #define RANDOMIZER_H
 
+#include <vector>
+
+#include <stdint.h>
+#include <pthread.h>
+
 #include "base/Serializable.h"
 #include "utils/SizeTSupport.h"
 #include "utils/IsReal.h"
 #include "utils/IsInteger.h"
 
-/** The Randomizer class implements random sampling from several distributions
+/** The Randomizer class implements random sampling from several
+    distributions. Each instance owns a xoshiro256** engine, so that instances
+    used by different threads neither share state nor lock. An instance must
+    therefore not be shared across threads; getLocal() returns one per thread.
     \brief Random sampling from distributions
   */
 template <typename T = double, size_t M = 1> class Randomizer :
@@ -70,8 +78,10 @@ public:
     */
   /// Sets the seed of the random sampler
   void setSeed(const T& seed);
-  /// Returns the seed of the random sampler
+  /// Returns a new seed for a random sampler
   static T getSeed();
+  /// Returns the randomizer of the calling thread, seeded on first use
+  static const Randomizer& getLocal();
   /** @}
     */
 
@@ -93,6 +103,19 @@ public:
   size_t sampleGeometric(double successProbability = 0.5) const;
   /// Returns a sample from a gamma distribution
   double sampleGamma(double shape = 1.0, double invScale = 1.0) const;
+  /// Fills a vector with samples from a uniform distribution
+  void sampleUniform(Eigen::Matrix<T, Eigen::Dynamic, 1>& samples,
+    const T& minSupport = T(0), const T& maxSupport = T(1)) const;
+  /// Fills a vector with samples from a normal distribution
+  void sampleNormal(Eigen::Matrix<T, Eigen::Dynamic, 1>& samples,
+    const T& mean = T(0), const T& variance = T(1)) const;
+  /// Samples from categorical distributions, one distribution per row
+  void sampleCategorical(const Eigen::Matrix<double, Eigen::Dynamic, M>&
+    probabilities, std::vector<size_t>& samples) const;
+  /// Advances the engine by 2^128 draws for non-overlapping streams
+  void jump();
+  /// Returns the stream-th non-overlapping stream of the current seed
+  Randomizer getStream(size_t stream) const;
   /** @}
     */
 
@@ -111,11 +134,40 @@ protected:
   /** @}
     */
 
+  /** \name Protected methods
+    @{
+    */
+  /// Returns the next output of the engine
+  uint64_t next() const;
+  /// Returns the next uniform sample in [0, 1)
+  double nextUniform() const;
+  /// Returns the next output of a SplitMix64 generator
+  static uint64_t splitMix(uint64_t& state);
+  /// Creates the key releasing the randomizers of exiting threads
+  static void createLocalKey();
+  /// Deletes the randomizer of an exiting thread
+  static void deleteLocal(void* randomizer);
+  /** @}
+    */
+
+  /** 
+ame Protected static members
+    @{
+    */
+  /// Key releasing the randomizers of exiting threads
+  static pthread_key_t localKey;
+  /// Creation flag of the key
+  static pthread_once_t localKeyOnce;
+  /** @}
+    */
+
   /** \name Protected members
     @{
     */
   /// Seed of the random sampling
   T mSeed;
+  /// State of the engine
+  mutable uint64_t mState[4];
   /** @}
     */
 
@@ -20,25 +20,40 @@
 
 #include "base/Timestamp.h"
 #include "exceptions/BadArgumentException.h"
+#include "exceptions/SystemException.h"
+
+/******************************************************************************/
+/* Statics                                                                    */
+/******************************************************************************/
+
+template <typename T, size_t M>
+pthread_key_t Randomizer<T, M>::localKey;
+
+template <typename T, size_t M>
+pthread_once_t Randomizer<T, M>::localKeyOnce = PTHREAD_ONCE_INIT;
 
 /******************************************************************************/
 /* Constructors and Destructor                                                */
 /******************************************************************************/
 
 template <typename T, size_t M>
-Randomizer<T, M>::Randomizer(const T& seed) :
-    mSeed(seed) {
+Randomizer<T, M>::Randomizer(const T& seed) {
+  setSeed(seed);
 }
 
 template <typename T, size_t M>
 Randomizer<T, M>::Randomizer(const Randomizer& other) :
     mSeed(other.mSeed) {
+  for (size_t i = 0; i < 4; ++i)
+    mState[i] = other.mState[i];
 }
 
 template <typename T, size_t M>
 Randomizer<T, M>& Randomizer<T, M>::operator = (const Randomizer& other) {
   if (this != &other) {
     mSeed = other.mSeed;
+    for (size_t i = 0; i < 4; ++i)
+      mState[i] = other.mState[i];
   }
   return *this;
 }
@@ -75,25 +90,102 @@ void Randomizer<T, M>::write(std::ofstream& stream) const {
 template <typename T, size_t M>
 void Randomizer<T, M>::setSeed(const T& seed) {
   mSeed = seed;
-  srandom(seed);
+  uint64_t state = (uint64_t)seed;
+  for (size_t i = 0; i < 4; ++i)
+    mState[i] = splitMix(state);
 }
 
 template <typename T, size_t M>
 T Randomizer<T, M>::getSeed() {
-  static bool seeded = false;
-  if (!seeded) {
-    const double time = Timestamp::now();
-    const T seed = (time - floor(time)) * 1e6;
-    srandom(seed);
-    seeded = true;
+  static uint64_t counter = 0;
+  const double time = Timestamp::now();
+  uint64_t state = (uint64_t)((time - floor(time)) * 1e6) +
+    (__sync_fetch_and_add(&counter, 1) << 20);
+  return splitMix(state) >> 33;
+}
+
+template <typename T, size_t M>
+const Randomizer<T, M>& Randomizer<T, M>::getLocal() {
+  static __thread Randomizer* localRandomizer = 0;
+  if (!localRandomizer) {
+    pthread_once(&localKeyOnce, createLocalKey);
+    Randomizer* randomizer = new Randomizer();
+    const int error = pthread_setspecific(localKey, randomizer);
+    if (error) {
+      delete randomizer;
+      throw SystemException(error,
+        "Randomizer<T, M>::getLocal()::pthread_setspecific()");
+    }
+    localRandomizer = randomizer;
   }
-  return random();
+  return *localRandomizer;
 }
 
 /******************************************************************************/
 /* Methods                                                                    */
 /******************************************************************************/
 
+template <typename T, size_t M>
+void Randomizer<T, M>::createLocalKey() {
+  pthread_key_create(&localKey, deleteLocal);
+}
+
+template <typename T, size_t M>
+void Randomizer<T, M>::deleteLocal(void* randomizer) {
+  delete static_cast<Randomizer*>(randomizer);
+}
+
+template <typename T, size_t M>
+uint64_t Randomizer<T, M>::splitMix(uint64_t& state) {
+  uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+template <typename T, size_t M>
+uint64_t Randomizer<T, M>::next() const {
+  const uint64_t product = mState[1] * 5;
+  const uint64_t result = ((product << 7) | (product >> 57)) * 9;
+  const uint64_t shifted = mState[1] << 17;
+  mState[2] ^= mState[0];
+  mState[3] ^= mState[1];
+  mState[1] ^= mState[2];
+  mState[0] ^= mState[3];
+  mState[2] ^= shifted;
+  mState[3] = (mState[3] << 45) | (mState[3] >> 19);
+  return result;
+}
+
+template <typename T, size_t M>
+double Randomizer<T, M>::nextUniform() const {
+  return (next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+template <typename T, size_t M>
+void Randomizer<T, M>::jump() {
+  static const uint64_t jumpPolynomial[] = {0x180ec6d33cfd0abaULL,
+    0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+  uint64_t state[4] = {0, 0, 0, 0};
+  for (size_t i = 0; i < 4; ++i)
+    for (size_t b = 0; b < 64; ++b) {
+      if (jumpPolynomial[i] & (1ULL << b))
+        for (size_t j = 0; j < 4; ++j)
+          state[j] ^= mState[j];
+      next();
+    }
+  for (size_t i = 0; i < 4; ++i)
+    mState[i] = state[i];
+}
+
+template <typename T, size_t M>
+Randomizer<T, M> Randomizer<T, M>::getStream(size_t stream) const {
+  Randomizer<T, M> randomizer(mSeed);
+  for (size_t i = 0; i < stream; ++i)
+    randomizer.jump();
+  return randomizer;
+}
+
 template <typename T, size_t M>
 T Randomizer<T, M>::sampleUniform(const T& minSupport, const T& maxSupport)
     const {
@@ -102,8 +194,8 @@ T Randomizer<T, M>::sampleUniform(const T& minSupport, const T& maxSupport)
       "Randomizer<T, M>::sampleUniform(): minimum support must be smaller "
       "than maximum support",
       __FILE__, __LINE__);
-  return minSupport + Traits::template round<T, true>(random() /
-    (double)RAND_MAX * (maxSupport - minSupport));
+  return minSupport + Traits::template round<T, true>(nextUniform() *
+    (maxSupport - minSupport));
 }
 
 template <typename T, size_t M>
@@ -228,6 +320,51 @@ double Randomizer<T, M>::sampleGamma(double shape, double invScale) const {
   return (y + z) / invScale;
 }
 
+template <typename T, size_t M>
+void Randomizer<T, M>::sampleUniform(Eigen::Matrix<T, Eigen::Dynamic, 1>&
+    samples, const T& minSupport, const T& maxSupport) const {
+  if (minSupport >= maxSupport)
+    throw BadArgumentException<T>(minSupport,
+      "Randomizer<T, M>::sampleUniform(): minimum support must be smaller "
+      "than maximum support",
+      __FILE__, __LINE__);
+  for (size_t i = 0; i < (size_t)samples.size(); ++i)
+    samples(i) = minSupport + Traits::template round<T, true>(nextUniform() *
+      (maxSupport - minSupport));
+}
+
+template <typename T, size_t M>
+void Randomizer<T, M>::sampleNormal(Eigen::Matrix<T, Eigen::Dynamic, 1>&
+    samples, const T& mean, const T& variance) const {
+  if (variance <= 0)
+    throw BadArgumentException<T>(variance,
+      "Randomizer<T, M>::sampleNormal(): variance must be strictly positive",
+      __FILE__, __LINE__);
+  const double standardDeviation = sqrt(variance);
+  for (size_t i = 0; i < (size_t)samples.size(); i += 2) {
+    double u, v, s;
+    do {
+      u = 2.0 * nextUniform() - 1.0;
+      v = 2.0 * nextUniform() - 1.0;
+      s = u * u + v * v;
+    }
+    while (s >= 1.0 || s == 0.0);
+    const double factor = standardDeviation * sqrt(-2.0 * log(s) / s);
+    samples(i) = Traits::template round<T, true>(mean + u * factor);
+    if (i + 1 < (size_t)samples.size())
+      samples(i + 1) = Traits::template round<T, true>(mean + v * factor);
+  }
+}
+
+template <typename T, size_t M>
+void Randomizer<T, M>::sampleCategorical(const
+    Eigen::Matrix<double, Eigen::Dynamic, M>& probabilities,
+    std::vector<size_t>& samples) const {
+  samples.resize(probabilities.rows());
+  for (size_t i = 0; i < samples.size(); ++i)
+    samples[i] = sampleCategorical(probabilities.row(i).transpose());
+}
+
 template <typename T, size_t M>
 template <typename Z, typename IsReal<Z>::Result::Numeric>
 Z Randomizer<T, M>::Traits::round(const Z& value) {
@@ -27,7 +27,7 @@ namespace RejectionSampler {
 template <typename Y, typename X>
 X getSample(const Function<Y, X>& target, const
     SampleDistribution<X>& proposal, double k) {
-  const static Randomizer<double> randomizer;
+  const Randomizer<double>& randomizer = Randomizer<double>::getLocal();
   while (1) {
     const X z0 = proposal.getSample();
     const double u0 = randomizer.sampleUniform(0, k * proposal(z0));
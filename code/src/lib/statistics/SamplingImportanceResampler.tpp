@@ -43,7 +43,8 @@ void getSamples(const Function<Y, X>& target, const SampleDistribution<X>&
     normalizer += weight;
   }
   Eigen::Matrix<double, Eigen::Dynamic, 1> probabilities(numSamples);
-  static const Randomizer<double, Eigen::Dynamic> randomizer;
+  const Randomizer<double, Eigen::Dynamic>& randomizer =
+    Randomizer<double, Eigen::Dynamic>::getLocal();
   for (size_t i = 0; i < numSamples; ++i) {
     weights[i] /= normalizer;
     probabilities(i) = weights[i];
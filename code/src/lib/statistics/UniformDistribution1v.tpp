@@ -135,7 +135,7 @@ double UniformDistribution<X>::pmf(const RandomVariable& value) const {
 template <typename X>
 typename UniformDistribution<X>::RandomVariable
     UniformDistribution<X>::getSample() const {
-  const static Randomizer<X> randomizer;
+  const Randomizer<X>& randomizer = Randomizer<X>::getLocal();
   return randomizer.sampleUniform(mMinSupport, mMaxSupport);
 }
 
@@ -143,7 +143,7 @@ double UniformDistribution<X, M>::pmf(const RandomVariable& value) const {
 template <typename X, size_t M>
 typename UniformDistribution<X, M>::RandomVariable
     UniformDistribution<X, M>::getSample() const {
-  const static Randomizer<X> randomizer;
+  const Randomizer<X>& randomizer = Randomizer<X>::getLocal();
   RandomVariable sample(mMinSupport.size());
   for (size_t i = 0; i < (size_t)sample.size(); ++i)
     sample(i) = randomizer.sampleUniform(mMinSupport(i), mMaxSupport(i));
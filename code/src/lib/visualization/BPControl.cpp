@@ -26,7 +26,7 @@
 #include "helpers/FGTools.h"
 #include "data-structures/PropertySet.h"
 #include "ml/BeliefPropagation.h"
-#include "base/Timestamp.h"
+#include "base/ScopedTimer.h"
 #include "utils/IndexHash.h"
 #include "data-structures/TransGrid.h"
 #include "data-structures/Cell.h"
@@ -227,7 +227,7 @@ void BPControl::runBP() {
   std::vector<size_t> mapState;
   mapState.reserve(mFactorGraph.nrVars());
   if (mFactorGraph.factors()[0].nrStates() > 1) {
-    const double before = Timestamp::now();
+    ScopedTimer timer("BPControl::runBP()");
     PropertySet opts;
     opts.set("maxiter", (size_t)mMaxIter);
     opts.set("tol", mTol);
@@ -244,10 +244,10 @@ void BPControl::runBP() {
       std::cout << e.what() << std::endl;
       return;
     }
-    const double after = Timestamp::now();
+    const double time = timer.stop();
     mUi->iterSpinBox->setValue(bp.Iterations());
     mUi->llSpinBox->setValue(bp.logZ());
-    mUi->timeSpinBox->setValue(after - before);
+    mUi->timeSpinBox->setValue(time);
     if (mAlgo.compare("MAXPROD") == 0)
       mapState = bp.findMaximum();
     else {
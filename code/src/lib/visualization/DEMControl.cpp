@@ -19,7 +19,7 @@
 #include "visualization/DEMControl.h"
 
 #include "visualization/PointCloudControl.h"
-#include "base/Timestamp.h"
+#include "base/ScopedTimer.h"
 #include "data-structures/TransGrid.h"
 #include "data-structures/Cell.h"
 
@@ -148,7 +148,7 @@ void DEMControl::demChanged() {
   const double cellSizeX = mUi->resXSpinBox->value();
   const double cellSizeY = mUi->resYSpinBox->value();
   const double sensorVariance = mUi->sensorSpinBox->value();
-  const double before = Timestamp::now();
+  ScopedTimer timer("DEMControl::demChanged()");
   if (mDEM)
     delete mDEM;
   mDEM = new
@@ -166,8 +166,7 @@ void DEMControl::demChanged() {
       (*mDEM)(point).addPoint((*it)(2));
     }
   }
-  const double after = Timestamp::now();
-  mUi->timeSpinBox->setValue(after - before);
+  mUi->timeSpinBox->setValue(timer.stop());
   View3d::getInstance().update();
   emit demUpdated(*mDEM);
 }
@@ -117,18 +117,17 @@ void EvaluatorControl::labelDEM() {
   catch (IOException& e) {
     return;
   }
+  const Evaluator::LabelMap labelMap = mEvaluator.getLabelMap(*mDEM);
   const Grid<double, Cell, 2>::Index& numCells = mDEM->getNumCells();
   for (size_t i = 0; i < numCells(0); ++i)
     for (size_t j = 0; j < numCells(1); ++j) {
-      const Cell& cell =
-        (*mDEM)[(Eigen::Matrix<size_t, 2, 1>() << i, j).finished()];
+      const Eigen::Matrix<size_t, 2, 1> idx =
+        (Eigen::Matrix<size_t, 2, 1>() << i, j).finished();
+      const Cell& cell = (*mDEM)[idx];
       if (!cell.getHeightEstimator().getDist().getKappa())
         continue;
-      const Eigen::Matrix<double, 2, 1> point = 
-        mDEM->getCoordinates((Eigen::Matrix<size_t, 2, 1>() << i, j).
-        finished());
-      mVertices[(Eigen::Matrix<size_t, 2, 1>() << i, j).finished()] =
-        mEvaluator.getLabel(point);
+      const size_t label = labelMap[mDEM->computeLinearIndex(idx)];
+      mVertices[idx] = (label == Evaluator::noClass) ? 0 : label;
     }
   mUi->showGroundTruthCheckBox->setEnabled(true);
   View3d::getInstance().update();
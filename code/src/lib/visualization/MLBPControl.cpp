@@ -23,7 +23,7 @@
 #include "visualization/SegmentationControl.h"
 #include "statistics/EstimatorMLBPMixtureLinearRegression.h"
 #include "helpers/InitML.h"
-#include "base/Timestamp.h"
+#include "base/ScopedTimer.h"
 #include "utils/IndexHash.h"
 #include "data-structures/TransGrid.h"
 #include "data-structures/Cell.h"
@@ -152,7 +152,7 @@ void MLBPControl::segmentUpdated(const TransGrid<double, Cell, 2>& dem, const
 }
 
 void MLBPControl::runML() {
-  const double before = Timestamp::now();
+  ScopedTimer timer("MLBPControl::runML()");
   EstimatorML<LinearRegression<3> >::Container points;
   std::vector<DEMGraph::VertexDescriptor> pointsMapping;
   MixtureDistribution<LinearRegression<3>, Eigen::Dynamic>* initMixture = 0;
@@ -166,9 +166,8 @@ void MLBPControl::runML() {
       const size_t numIter = estMixtPlane.addPointsEM(points.begin(),
         points.end());
       if (estMixtPlane.getValid()) {
-        const double after = Timestamp::now();
         mUi->iterSpinBox->setValue(numIter);
-        mUi->timeSpinBox->setValue(after - before);
+        mUi->timeSpinBox->setValue(timer.stop());
         mUi->llSpinBox->setValue(estMixtPlane.getLogLikelihood());
         mVertices = estMixtPlane.getVerticesLabels();
         if (mMixtureDist)
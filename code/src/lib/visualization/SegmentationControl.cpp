@@ -19,7 +19,7 @@
 #include "visualization/SegmentationControl.h"
 
 #include "visualization/DEMControl.h"
-#include "base/Timestamp.h"
+#include "base/ScopedTimer.h"
 #include "data-structures/TransGrid.h"
 #include "data-structures/Cell.h"
 #include "utils/Colors.h"
@@ -103,12 +103,11 @@ void SegmentationControl::render(View3d& view, Scene3d& scene) {
 }
 
 void SegmentationControl::segment() {
-  const double before = Timestamp::now();
+  ScopedTimer timer("SegmentationControl::segment()");
   DEMGraph* graph = new DEMGraph(*mDEM);
   GraphSegmenter<DEMGraph>::segment(*graph, mComponents, graph->getVertices(),
     mK);
-  const double after = Timestamp::now();
-  mUi->timeSpinBox->setValue(after - before);
+  mUi->timeSpinBox->setValue(timer.stop());
   mUi->showSegmentationCheckBox->setEnabled(true);
   View3d::getInstance().update();
   emit segmentUpdated(*mDEM, *graph, mComponents);